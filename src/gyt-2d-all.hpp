@@ -0,0 +1,158 @@
+#include <thread>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////////
+// The rows are cut into chunks, taken by the threads in increasing
+// order.  The staircase enters a chunk at the column where it leaves
+// the row before, which is found by binary search; from there every
+// chunk repeats the steps of the sequential walk over its rows, so the
+// solutions, printed in chunk order, are those of the sequential walk.
+// Rows ruled out by the residue filter are passed without walking their
+// columns; the next row starts from the same column.
+
+struct worker_stats {
+  long long saved = 0;
+  bigint columns = 0;
+  bigint filtered = 0;
+  bigint evals = 0;
+  bigint deltas = 0;
+};
+
+template <typename N>
+struct chunk {
+  N first, last;		// rows [first, last)
+  vector<val_tuple<N>> sols;
+};
+
+template <typename N>
+static void walk (const polynomial<N> &p, const N &B,
+		  const val_tuple<N> &bound, const residue_filter &f,
+		  eval_state<N> &es, chunk<N> &c, bigint id) {
+  N row = c.first;
+  N column = bound[1];
+  if (f.impossible || (row > 0 && !leave_column(p, B, N(row-1), column)))
+    return;
+  val_tuple<N> val = {row, column};
+  while (val[0] < c.last && val[1] >= 0 && val[0] <= val[1]) {
+    N result = eval(p, es, val);
+    while (result != B) {
+      publish(id, val, 0, 0);
+      if (result > B && !column_possible(f, p, val)) {
+	if (++val[0] == c.last || val[0] > val[1])
+	  return;
+	result = eval(p, es, val);
+      } else if (result < B
+		 ? !gallop(p, es, val, 0, min(N(c.last-1), val[1]), B, result)
+		 : !gallop(p, es, val, 1, val[0], B, result))
+	return;
+    }
+    c.sols.push_back(val);
+    val[1]--;
+  }
+}
+
+template <typename N>
+static void worker (const polynomial<N> &p, const N &B,
+		    const val_tuple<N> &bound, const residue_filter &f,
+		    vector<chunk<N>> &chunks, atomic<bigint> &next,
+		    worker_stats &ws, bigint id) {
+  eval_state<N> es;
+  for (bigint i = next++; i < chunks.size(); i = next++)
+    walk(p, B, bound, f, es, chunks[i], id);
+  ws.saved = num_of_saved;
+  ws.columns = num_of_columns;
+  ws.filtered = num_of_filtered;
+  ws.evals = num_of_evals;
+  ws.deltas = num_of_deltas;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  bigint nres = 0;
+  bigint jobs = 1;
+  bool residues = false;
+  double heartbeat = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "j:rH:J:")) != -1)
+    if (opt == 'j')
+      jobs = max(1LL, atoll(optarg));
+    else if (opt == 'r')
+      residues = true;
+    else if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-j threads] [-r] [-H seconds]"
+	   << " [-J file]" << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  val_tuple<N> bound = get_bounds(p, B);
+  power_tables(p, bound);
+  residue_filter f;
+  if (residues)
+    init_filter(f, p, B);
+
+  phase("search");
+  N rows = bound[0];
+  bigint n = 1;
+  if (jobs > 1)
+    n = rows < 8*jobs ? max(1UL, word(rows, 0)) : 8*jobs;
+  vector<chunk<N>> chunks(n);
+  N q = rows / n, r = rows % n;
+  for (bigint i = 0; i < n; ++i) {
+    chunks[i].first = q * i + min(N(i), r);
+    chunks[i].last = q * (i+1) + min(N(i+1), r);
+  }
+
+  atomic<bigint> next(0);
+  vector<worker_stats> ws(jobs);
+  vector<thread> threads;
+  start_progress(jobs, heartbeat);
+  for (bigint t = 0; t < jobs; ++t)
+    threads.emplace_back(worker<N>, cref(p), cref(B), cref(bound), cref(f),
+			 ref(chunks), ref(next), ref(ws[t]), t);
+  for (thread &t : threads)
+    t.join();
+  stop_progress();
+  for (const worker_stats &w : ws) {
+    num_of_saved += w.saved;
+    num_of_columns += w.columns;
+    num_of_filtered += w.filtered;
+    num_of_evals += w.evals;
+    num_of_deltas += w.deltas;
+  }
+
+  phase("output");
+  for (const chunk<N> &c : chunks)
+    for (const val_tuple<N> &val : c.sols) {
+      nres++;
+      cout << endl << "*** solution for values:" << endl;
+      cout << "    x_1 = " << val[0] << endl;
+      cout << "    x_2 = " << val[1] << endl;
+    }
+
+  cout << endl;
+  cout << "+++ number of solutions = " << nres << endl;
+  cout << "*** steps saved = " << num_of_saved << endl;
+  cout << "    # of evals = " << num_of_evals << endl;
+  cout << "    # of deltas = " << num_of_deltas << endl;
+  if (num_of_columns > 0)
+    cout << "    residue hits = " << num_of_filtered << " of "
+	 << num_of_columns << " ("
+	 << 100 * num_of_filtered / num_of_columns << "%)" << endl;
+  stats.solutions = nres;
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,158 @@
+#include <thread>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////////
+// The rows are cut into chunks, taken by the threads in increasing
+// order, and every chunk repeats the steps of the sequential walk over
+// its rows from the column found by binary search (see gyt-2d-all).
+// A chunk that reaches B cancels the chunks above it, but not those
+// below, so the solution reported is the one of the sequential walk.
+// Rows ruled out by the residue filter are passed without walking their
+// columns; the next row starts from the same column.
+
+template <typename N>
+struct chunk {
+  N first, last;		// rows [first, last)
+  val_tuple<N> sol;
+};
+
+template <typename N>
+struct first_search {
+  const polynomial<N> &p;
+  const N B;
+  const val_tuple<N> &bound;
+  vector<chunk<N>> chunks;
+  atomic<bigint> next;
+  atomic<bigint> best;		// lowest chunk with a solution
+  atomic<long long> saved;
+  residue_filter filter;
+  atomic<bigint> columns, filtered;
+  atomic<bigint> evals, deltas;
+  first_search (const polynomial<N> &p, const N &B, const val_tuple<N> &bound,
+		bigint n) :
+    p(p), B(B), bound(bound), chunks(n), next(0), best(n), saved(0),
+    columns(0), filtered(0), evals(0), deltas(0) {}
+};
+
+template <typename N>
+static void walk (first_search<N> &s, eval_state<N> &es, bigint i,
+		  bigint id) {
+  const polynomial<N> &p = s.p;
+  chunk<N> &c = s.chunks[i];
+  N row = c.first;
+  N column = s.bound[1];
+  if (s.filter.impossible ||
+      (row > 0 && !leave_column(p, s.B, N(row-1), column)))
+    return;
+  val_tuple<N> val = {row, column};
+  N result = eval(p, es, val);
+  while (result != s.B) {
+    publish(id, val, 0, 0);
+    if (i > s.best)
+      return;
+    else if (result > s.B && !column_possible(s.filter, p, val)) {
+      if (++val[0] == c.last)
+	return;
+      result = eval(p, es, val);
+    } else if (result < s.B
+	       ? !gallop(p, es, val, 0, N(c.last-1), s.B, result)
+	       : !gallop(p, es, val, 1, N(0), s.B, result))
+      return;
+  }
+  c.sol = val;
+  bigint b = s.best;
+  while (i < b && !s.best.compare_exchange_weak(b, i))
+    ;
+}
+
+template <typename N>
+static void worker (first_search<N> &s, bigint id) {
+  eval_state<N> es;
+  for (bigint i = s.next++; i < s.chunks.size() && i < s.best; i = s.next++)
+    walk(s, es, i, id);
+  s.saved += num_of_saved;
+  s.columns += num_of_columns;
+  s.filtered += num_of_filtered;
+  s.evals += num_of_evals;
+  s.deltas += num_of_deltas;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  bigint jobs = 1;
+  bool residues = false;
+  double heartbeat = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "j:rH:J:")) != -1)
+    if (opt == 'j')
+      jobs = max(1LL, atoll(optarg));
+    else if (opt == 'r')
+      residues = true;
+    else if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-j threads] [-r] [-H seconds]"
+	   << " [-J file]" << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  val_tuple<N> bound = get_bounds(p, B);
+  power_tables(p, bound);
+
+  phase("search");
+  N rows = bound[0] + 1;
+  bigint n = jobs == 1 ? 1 : rows < 8*jobs ? word(rows, 0) : 8*jobs;
+  first_search<N> s(p, B, bound, n);
+  N q = rows / n, r = rows % n;
+  if (residues)
+    init_filter(s.filter, p, B);
+  for (bigint i = 0; i < n; ++i) {
+    s.chunks[i].first = q * i + min(N(i), r);
+    s.chunks[i].last = q * (i+1) + min(N(i+1), r);
+  }
+
+  start_progress(jobs, heartbeat);
+  vector<thread> threads;
+  for (bigint t = 0; t < jobs; ++t)
+    threads.emplace_back(worker<N>, ref(s), t);
+  for (thread &t : threads)
+    t.join();
+  stop_progress();
+  num_of_evals += s.evals;
+  num_of_deltas += s.deltas;
+  num_of_saved += s.saved;
+  num_of_columns += s.columns;
+  num_of_filtered += s.filtered;
+
+  phase("output");
+  stats.solutions = s.best < n;
+  if (s.best < n) {
+    const val_tuple<N> &val = s.chunks[s.best].sol;
+    cout << endl << "+++ YES +++" << endl;
+    cout << "*** for values:" << endl;
+    cout << "    x_1 = " << val[0] << endl;
+    cout << "    x_2 = " << val[1] << endl;
+  } else
+    cout << endl << "+++ NO +++" << endl;
+  cout << "*** steps saved = " << num_of_saved << endl;
+  cout << "    # of evals = " << num_of_evals << endl;
+  cout << "    # of deltas = " << num_of_deltas << endl;
+  if (num_of_columns > 0)
+    cout << "    residue hits = " << num_of_filtered << " of "
+	 << num_of_columns << " ("
+	 << 100 * num_of_filtered / num_of_columns << "%)" << endl;
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
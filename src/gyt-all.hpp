@@ -0,0 +1,561 @@
+#include <set>
+#include <thread>
+#include <atomic>
+#include <getopt.h>
+
+//////////////////////////////////////////////////////////////////////////////
+// Every thread explores from its own deque and steals the oldest tuples
+// of the others when it runs dry.  The memo is shared, so every tuple is
+// still expanded once, and the solutions go through one set under the
+// output lock, so the solutions and their number are those of a
+// sequential run.  With one thread the order of the search is exactly
+// the sequential one.
+//
+// Only canonical tuples are searched, see symmetries(); every canonical
+// solution is printed with its permutations unless canonical is set.
+// Besides the point where a walk goes below B, children are pushed from
+// the solutions on the way where they are solutions too, see
+// solution_step(), so that every canonical tuple is reached.
+// With unique set, every tuple is pushed by one parent only, see
+// unique_step(), and neither the memo nor the set of solutions is kept.
+// With -l, the tableau is walked level by level instead, see
+// search_levels().
+//
+// With prune set, a node is dropped if its box cannot reach B, see
+// prune_node().  Columns ruled out by the residue filter are not walked,
+// see skip_column().  box_search() does not walk the tableau at all but
+// splits boxes, see below.
+//
+// With -C file, the threads are stopped every -T seconds, and on
+// SIGUSR2, SIGTERM or SIGINT, and the memo, deques, solutions and
+// counters are written to file, see write_checkpoint().  --resume
+// continues from there, printing the solutions found before first.
+
+template <typename N>
+struct all_search {
+  const polynomial<N> &p;
+  const N B;
+  const val_tuple<N> &bound;
+  vector<work_deque<N>> deques;
+  shared_set memo;
+  set<val_tuple<N>> sols;
+  bigint nres;
+  bigint ncanon;
+  bool canonical;		// print canonical solutions only
+  bool unique;			// one parent per tuple, see unique_step()
+  bool prune;			// drop nodes whose box cannot reach B
+  residue_filter filter;	// skip columns without solutions, if any
+  mutex out;
+  atomic<bigint> pending;	// tuples queued or being expanded
+  vector<atomic<bigint>> hands;	// level of the node of each thread
+  atomic<bool> pause;		// stop the workers for a checkpoint
+  all_search (const polynomial<N> &p, const N &B, const val_tuple<N> &bound,
+	      bigint jobs) :
+    p(p), B(B), bound(bound), deques(jobs), memo(jobs > 1 ? 64*jobs : 1),
+    hands(jobs) {
+    for (atomic<bigint> &h : hands)
+      h = 0;
+  }
+};
+
+struct worker_stats {
+  bigint maxstack = 1;
+  bigint nback = 0;
+  bigint split = 0;
+  bigint dbl = 0;
+  bigint steals = 0;
+  bigint evals = 0;
+  bigint deltas = 0;
+  long long saved = 0;
+  bigint cuts = 0;
+  bigint boxes = 0;
+  bigint pruned = 0;
+  long double volume = 0;
+  bigint columns = 0;
+  bigint filtered = 0;
+};
+
+static void add_stats (worker_stats &a, const worker_stats &b) {
+  a.maxstack += b.maxstack;
+  a.nback += b.nback;
+  a.split += b.split;
+  a.dbl += b.dbl;
+  a.steals += b.steals;
+  a.evals += b.evals;
+  a.deltas += b.deltas;
+  a.saved += b.saved;
+  a.cuts += b.cuts;
+  a.boxes += b.boxes;
+  a.pruned += b.pruned;
+  a.volume += b.volume;
+  a.columns += b.columns;
+  a.filtered += b.filtered;
+}
+
+// the counters of the threads added to those before the checkpoint; the
+// peak of the stacks is the one of the threads together
+static worker_stats total (const vector<worker_stats> &ws,
+			   const worker_stats &done) {
+  worker_stats t = done;
+  t.maxstack = 0;
+  for (const worker_stats &w : ws)
+    add_stats(t, w);
+  t.maxstack = max(t.maxstack, done.maxstack);
+  return t;
+}
+
+// prints a canonical solution and its permutations
+template <typename N>
+static void show (all_search<N> &s, const val_tuple<N> &val,
+		  vector<val_tuple<N>> &perms) {
+  if (s.canonical)
+    perms.assign(1, val);
+  else
+    expand(s.p, val, perms);
+  s.ncanon++;
+  for (const val_tuple<N> &v : perms) {
+    s.nres++;
+    cout << endl << "*** solution for values:" << endl;
+    for (bigint i = 0; i < s.p.k; ++i)
+      cout << "    x_" << i+1 << " = " << v[i] << endl;
+  }
+}
+
+// prints a new canonical solution, false if it was there already
+template <typename N>
+static bool record (all_search<N> &s, const val_tuple<N> &val,
+		    vector<val_tuple<N>> &perms) {
+  lock_guard<mutex> guard(s.out);
+  if (!s.unique && !s.sols.insert(val).second)
+    return false;
+  show(s, val, perms);
+  return true;
+}
+
+template <typename N>
+static void worker (all_search<N> &s, bigint id, worker_stats &ws) {
+  const polynomial<N> &p = s.p;
+  const bigint jobs = s.deques.size();
+  eval_state<N> es;
+  val_tuple<N> val(p.k), valx(p.k), lim(p.k-1), node(2*p.k-1);
+  val_tuple<N> lo(p.k), hi(p.k);
+  vector<val_tuple<N>> perms;
+  vector<bool> pushed(p.k-1);
+  bool flip = true;
+  bigint frontier = 0, added = 0;
+  const bool bounded = s.memo.shard[0].limit != 0;
+  const bool memo = p.k > 2 && !s.unique;
+  while (!s.pause) {
+    if (bounded)
+      s.hands[id].store(0, memory_order_relaxed);
+    if (!pop(s.deques[id], node.data())) {
+      bool stolen = false;
+      for (bigint v = 1; v < jobs && !stolen; ++v)
+	stolen = steal(s.deques[(id+v) % jobs], node.data());
+      if (!stolen) {
+	if (s.pending == 0)
+	  break;
+	this_thread::yield();
+	continue;
+      }
+      ws.steals++;
+    }
+    unpack_node(p, node.data(), val, lim);
+    if (bounded)
+      s.hands[id].store(level(val.data(), p.k), memory_order_relaxed);
+    publish(id, val, frontier, added);
+    ws.nback += !flip;
+    flip = false;
+    if (s.prune && prune_node(p, s.B, val, lim, lo, hi)) {
+      s.pending--;
+      continue;
+    }
+
+    bigint put = 0;
+    fill(pushed.begin(), pushed.end(), false);
+    while (test_bound(val, s.bound, p.k) && val[p.k-1] >= 0 &&
+	   canonical_column(p, val)) {
+      N result = eval(p, es, val);
+      if (result > s.B &&
+	  !skip_column(p, es, s.filter, s.B, val, result) &&
+	  !gallop(p, es, val, p.k-1, column_floor(p, val), s.B, result))
+	break;
+      bool solution = result == s.B;
+      if (solution && !record(s, val, perms))
+	break;
+      for (bigint i = 0; i < p.k-1; ++i) {
+	valx = val;
+	valx[i]++;
+	if (pushed[i] || !canonical_step(p, val, i) ||
+	    (s.unique && !unique_step(val, i)))
+	  continue;
+	if (solution && !solution_step(p, es, s.B, valx, lim, i))
+	  continue;
+	const N *kx = valx.data();
+	pushed[i] = true;
+	if (memo && contains(s.memo, kx)) {
+	  ws.dbl++;
+	  continue;
+	}
+	if (!solution && !child_fits(p, es, s.B, valx, lim, i))
+	  continue;
+	if (!memo || (!column_done(p, es, s.B, s.memo, valx) &&
+		      insert(s.memo, kx))) {
+	  pack_node(p, valx, lim, node.data());
+	  push(s.deques[id], node.data());
+	  put++;
+	  added += memo;
+	  flip = true;
+	} else
+	  ws.dbl++;
+      }
+      frontier = deque_size(s.deques[id]);
+      ws.maxstack = max(ws.maxstack, frontier);
+      if (!solution)
+	break;
+      val[p.k-1]--;
+    }
+    ws.split += put > 1;
+    s.pending += put;
+    s.pending--;
+  }
+  ws.evals += num_of_evals;
+  ws.deltas += num_of_deltas;
+  ws.saved += num_of_saved;
+  ws.cuts += num_of_cuts;
+  ws.boxes += num_of_boxes;
+  ws.pruned += num_of_pruned;
+  ws.volume += pruned_volume;
+  ws.columns += num_of_columns;
+  ws.filtered += num_of_filtered;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// The options that shape the search, the input and the bounds are kept
+// with the state, so that a checkpoint is only resumed by the same
+// search.  The deques go back to the threads they came from, modulo
+// the number of threads; the memo keeps its number of shards.
+
+template <typename N>
+static void save (ostream &out, all_search<N> &s, bigint flags,
+		  const worker_stats &done) {
+  const polynomial<N> &p = s.p;
+  put_raw(out, flags);
+  put_raw(out, p.k);
+  put_tuple(out, p.coeffs);
+  for (const vector<bigint> &m : p.monomials)
+    out.write((const char *) m.data(), p.k * sizeof(bigint));
+  put_number(out, s.B);
+  put_tuple(out, s.bound);
+  put_raw(out, done);
+  put_raw(out, bigint(s.memo.shard.size()));
+  for (const tuple_set &t : s.memo.shard)
+    put_set(out, t);
+  put_raw(out, bigint(s.deques.size()));
+  for (const work_deque<N> &d : s.deques)
+    put_deque(out, d);
+  put_raw(out, bigint(s.sols.size()));
+  for (const val_tuple<N> &val : s.sols)
+    put_tuple(out, val);
+}
+
+template <typename N>
+static void load (istream &in, const string &file, all_search<N> &s,
+		  bigint flags, worker_stats &done) {
+  const polynomial<N> &p = s.p;
+  bigint f = 0, k = 0;
+  val_tuple<N> coeffs, bound;
+  N B;
+  get_raw(in, f);
+  get_raw(in, k);
+  if (!in || f != flags)
+    bad_checkpoint(file, "was written with other options");
+  get_tuple(in, coeffs);
+  bool same = k == p.k && coeffs == p.coeffs;
+  vector<bigint> exps(k);
+  for (bigint i = 0; i < coeffs.size() && same; ++i) {
+    in.read((char *) exps.data(), k * sizeof(bigint));
+    same = exps == p.monomials[i];
+  }
+  get_number(in, B);
+  get_tuple(in, bound);
+  if (!in || !same || B != s.B || bound != s.bound)
+    bad_checkpoint(file, "is for another input");
+  get_raw(in, done);
+
+  bigint n = 0;
+  get_raw(in, n);
+  s.memo.shard = vector<tuple_set>(n);
+  s.memo.locks = vector<mutex>(n);
+  init_shared(s.memo, s.bound, s.memo.shared);
+  if (!s.filter.moduli.empty())
+    init_columns(s.memo);
+  for (tuple_set &t : s.memo.shard)
+    get_set(in, t);
+  get_raw(in, n);
+  for (bigint i = 0; i < n && in; ++i)
+    get_deque(in, s.deques[i % s.deques.size()]);
+  s.pending = 0;
+  for (work_deque<N> &d : s.deques)
+    s.pending += deque_size(d);
+  get_raw(in, n);
+  val_tuple<N> val;
+  vector<val_tuple<N>> perms;
+  for (bigint i = 0; i < n && in; ++i) {
+    get_tuple(in, val);
+    show(s, val, perms);
+    s.sols.insert(val);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Branch and bound: the box [0, bound] of canonical tuples is split in
+// halves across its longest side, and every box where p cannot reach B
+// is dropped.  The boxes of a single tuple left over are the solutions.
+// The lower halves are split first.
+
+template <typename N>
+static void box_search (all_search<N> &s, worker_stats &ws) {
+  const polynomial<N> &p = s.p;
+  tuple_arena<N> stck;
+  init_arena(stck, 2*p.k);
+  val_tuple<N> lo(p.k, 0), hi = s.bound, box(2*p.k);
+  vector<val_tuple<N>> perms;
+  copy(lo.begin(), lo.end(), box.begin());
+  copy(hi.begin(), hi.end(), box.begin() + p.k);
+  if (!s.filter.impossible)
+    push(stck, box.data());
+  while (stck.count > 0) {
+    copy(top(stck), top(stck) + p.k, lo.begin());
+    copy(top(stck) + p.k, top(stck) + 2*p.k, hi.begin());
+    pop(stck);
+    publish(0, lo, stck.count, 0);
+    if (!canonical_box(p, lo, hi) || prune_box(p, s.B, lo, hi))
+      continue;
+    bigint axis = 0;
+    for (bigint i = 1; i < p.k; ++i)
+      if (hi[i] - lo[i] > hi[axis] - lo[axis])
+	axis = i;
+    if (lo[axis] == hi[axis]) {
+      record(s, lo, perms);
+      continue;
+    }
+    N mid = lo[axis] + (hi[axis] - lo[axis]) / 2;
+    copy(lo.begin(), lo.end(), box.begin());
+    copy(hi.begin(), hi.end(), box.begin() + p.k);
+    box[axis] = mid + 1;
+    push(stck, box.data());
+    box[axis] = lo[axis];
+    box[p.k + axis] = mid;
+    push(stck, box.data());
+    ws.split++;
+    ws.maxstack = max(ws.maxstack, stck.count);
+  }
+  ws.evals = num_of_evals;
+  ws.boxes = num_of_boxes;
+  ws.pruned = num_of_pruned;
+  ws.volume = pruned_volume;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  bigint jobs = 1;
+  bool canonical = false, symmetric = true, prune = false, boxes = false;
+  bool residues = false, resume = false, unique = false, levels = false;
+  bigint budget = 0;		// MB of memo, 0 for no bound
+  string spill;			// directory to spill the memo to
+  bigint quota = 0;		// MB on disk, 0 for no bound
+  double heartbeat = 0, every = 600;
+  string file;
+
+  const option longopts[] = {
+    {"resume", no_argument, nullptr, 'R'},
+    {nullptr, 0, nullptr, 0}
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "j:cSpbrulM:D:Q:C:T:RH:J:", longopts,
+			    nullptr)) != -1)
+    if (opt == 'j')
+      jobs = max(1LL, atoll(optarg));
+    else if (opt == 'c')
+      canonical = true;
+    else if (opt == 'S')
+      symmetric = false;
+    else if (opt == 'p')
+      prune = true;
+    else if (opt == 'b')
+      boxes = true;
+    else if (opt == 'r')
+      residues = true;
+    else if (opt == 'u')
+      unique = true;
+    else if (opt == 'l')
+      levels = true;
+    else if (opt == 'C')
+      file = optarg;
+    else if (opt == 'T')
+      every = atof(optarg);
+    else if (opt == 'R')
+      resume = true;
+    else if (opt == 'M')
+      budget = max(1LL, atoll(optarg));
+    else if (opt == 'D')
+      spill = optarg;
+    else if (opt == 'Q')
+      quota = max(0LL, atoll(optarg));
+    else if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-j threads] [-c] [-S] [-p] [-b] [-r]"
+	   << " [-u] [-l] [-M megabytes [-D dir [-Q megabytes]]]"
+	   << " [-C file [-T seconds] [--resume]]"
+	   << " [-H seconds] [-J file]" << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+  if ((resume && file.empty()) ||
+      ((boxes || unique || levels) && !file.empty())) {
+    cerr << "*** --resume needs -C, and -b, -u and -l have no checkpoints"
+	 << endl;
+    exit(1);
+  }
+  if (boxes + unique + levels > 1 ||
+      (budget > 0 && (boxes || unique || levels))) {
+    cerr << "*** -b, -u and -l exclude each other and -M" << endl;
+    exit(1);
+  }
+  if (!spill.empty() && (budget == 0 || !file.empty())) {
+    cerr << "*** -D needs -M and has no checkpoints" << endl;
+    exit(1);
+  }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  if (symmetric)
+    symmetries(p);
+  val_tuple<N> bound = get_bounds(p, B);
+  power_tables(p, bound);
+
+  all_search<N> s(p, B, bound, jobs);
+  init_shared(s.memo, bound, jobs > 1);
+  for (work_deque<N> &d : s.deques)
+    init_deque(d, 2*p.k-1, jobs > 1);
+  s.nres = 0;
+  s.ncanon = 0;
+  s.canonical = canonical;
+  s.unique = unique;
+  s.prune = prune;
+  if (residues)
+    init_filter(s.filter, p, B);
+  if (!s.filter.moduli.empty())
+    init_columns(s.memo);
+
+  phase("search");
+  bigint flags = symmetric | canonical << 1 | prune << 2 | residues << 3;
+  worker_stats done;
+  done.maxstack = 0;
+  val_tuple<N> val(p.k, 0), node(2*p.k-1);
+  val[p.k-1] = bound[p.k-1];
+  pack_node(p, val, bound, node.data());
+  vector<val_tuple<N>> perms;
+  level_search<N> l(p, B, bound, s.filter, prune,
+		    [&s, &perms](const val_tuple<N> &v) {
+		      show(s, v, perms);
+		      return true;
+		    });
+  s.pending = 0;
+  s.pause = false;
+  if (resume)
+    read_checkpoint(file, [&](istream &in) {
+      load(in, file, s, flags, done);
+    });
+  else if (levels) {
+    if (!s.filter.impossible)
+      l.level = node;
+  } else if (!s.filter.impossible) {
+    push(s.deques[0], node.data());
+    if (!unique)
+      insert(s.memo, val.data());
+    s.pending = 1;
+  }
+  if (budget > 0)
+    init_budget(s.memo, budget << 20, p, [&s, &p](vector<bigint> &mins) {
+      return frontier_floor(s.deques, s.hands, p.k, mins);
+    });
+  if (!spill.empty())
+    init_spill(s.memo, spill, quota << 20);
+  if (!file.empty())
+    watch_checkpoints();
+
+  vector<worker_stats> ws(boxes ? 1 : jobs);
+  start_progress(ws.size(), heartbeat);
+  if (levels)
+    search_levels(l, jobs);
+  vector<thread> threads;
+  for (bool more = !levels; more; ) {
+    if (boxes)
+      threads.emplace_back(box_search<N>, ref(s), ref(ws[0]));
+    else
+      for (bigint t = 0; t < jobs; ++t)
+	threads.emplace_back(worker<N>, ref(s), t, ref(ws[t]));
+    more = !file.empty() && checkpoint_due(s.pending, every);
+    s.pause = more;
+    for (thread &t : threads)
+      t.join();
+    threads.clear();
+    s.pause = false;
+    if (!more)
+      break;
+    write_checkpoint(file, checkpoint_stop, [&](ostream &out) {
+      save(out, s, flags, total(ws, done));
+    });
+    if (checkpoint_stop) {
+      stop_progress();
+      cout << endl << "+++ stopped, checkpoint written to " << file << endl;
+      return 2;
+    }
+  }
+  wait_checkpoint();
+  stop_progress();
+
+  worker_stats t = total(ws, done);
+  num_of_evals += t.evals;
+  num_of_deltas += t.deltas;
+  num_of_saved += t.saved;
+  num_of_cuts += t.cuts;
+  num_of_boxes += t.boxes;
+  num_of_pruned += t.pruned;
+  pruned_volume += t.volume;
+  num_of_columns += t.columns;
+  num_of_filtered += t.filtered;
+
+  phase("output");
+  stats.solutions = s.nres;
+  cout << endl;
+  cout << "+++ number of solutions = " << s.nres << endl;
+  if (!p.classes.empty())
+    cout << "+++ canonical solutions = " << s.ncanon << endl;
+  if (levels)
+    level_statistics(l);
+  else
+    statistics(set_count(s.memo), set_bytes(s.memo), "stack", t.maxstack,
+	       t.maxstack * (2*p.k-1) * sizeof(N), t.split, t.nback, t.dbl);
+  if (budget > 0)
+    budget_statistics(s.memo);
+  if (!spill.empty())
+    spill_statistics(s.memo);
+  if (ws.size() > 1) {
+    cout << "    # of threads    = " << jobs << endl;
+    cout << "    # of steals     = " << t.steals << endl;
+  }
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,581 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+const string header    = "Benchmark of the Generalized Young Tableaux";
+const string underline = "===========================================";
+
+//////////////////////////////////////////////////////////////////////////////
+// Every engine is run on every data file, repeatedly, with the file on
+// its standard input.  The wall time of a run is taken around fork and
+// wait, the peak resident set from the rusage of the child, and the
+// counters from the statistics the engine prints.  A run that times out
+// is not repeated.  The results go to <prefix>.csv and <prefix>.json;
+// given a baseline in the same CSV format, every median time or number
+// of evaluations above it by more than the threshold is a regression.
+
+const vector<string> engines = {
+  "gyt", "gyt-all", "gyt-pq", "gyt-rand", "gyt-proba",
+  "gyt-2d", "gyt-2d-all", "gyt-mitm",
+  "gyt-gmp", "gyt-all-gmp", "gyt-pq-gmp", "gyt-rand-gmp", "gyt-proba-gmp",
+  "gyt-2d-gmp", "gyt-2d-all-gmp", "gyt-mitm-gmp"
+};
+
+struct run {
+  string status;		// ok, timeout or error
+  double wall;			// seconds
+  long rss;			// peak resident set, KB
+  string out;			// standard output
+};
+
+struct result {
+  string engine, data, status;
+  int runs;
+  double wall_min, wall_median;
+  long long evals;		// evaluations and deltas, -1 if not printed
+  double evals_per_s;
+  long rss;
+  long long memo;		// memo size, -1 if none
+  long long stack;		// max stack or queue size, -1 if none
+};
+
+// waits until pid catches SIGTERM, then sends it, so that the program
+// stops at a checkpoint rather than dying; nothing if it exits first
+static void stop_when_caught (pid_t pid, double timeout) {
+  string path = "/proc/" + to_string(pid) + "/status";
+  auto start = chrono::steady_clock::now();
+  while (chrono::duration<double>
+	 (chrono::steady_clock::now() - start).count() < timeout) {
+    ifstream in(path);
+    if (!in)
+      return;
+    for (string line; getline(in, line); )
+      if (line.compare(0, 6, "State:") == 0 && line.find('Z') != string::npos)
+	return;
+      else if (line.compare(0, 7, "SigCgt:") == 0 &&
+	       strtoull(line.c_str() + 7, nullptr, 16) >> (SIGTERM - 1) & 1) {
+	kill(pid, SIGTERM);
+	return;
+      }
+    usleep(100);
+  }
+}
+
+// with stop, the program is sent SIGTERM as soon as it catches it
+static run execute (const string &path, const vector<string> &args,
+		    const string &data, double timeout, bool stop = false) {
+  run r = {"error", 0, 0, ""};
+  int in = open(data.c_str(), O_RDONLY);
+  int fd[2];
+  if (in < 0 || pipe(fd) != 0)
+    return r;
+  auto start = chrono::steady_clock::now();
+  pid_t pid = fork();
+  if (pid == 0) {
+    int null = open("/dev/null", O_WRONLY);
+    dup2(in, 0);
+    dup2(fd[1], 1);
+    dup2(null, 2);
+    close(fd[0]);
+    vector<char *> argv;
+    argv.push_back((char *) path.c_str());
+    for (const string &a : args)
+      argv.push_back((char *) a.c_str());
+    argv.push_back(nullptr);
+    execv(path.c_str(), argv.data());
+    _exit(127);
+  }
+  close(in);
+  close(fd[1]);
+  if (stop)
+    stop_when_caught(pid, timeout);
+  bool killed = false;
+  char buf[4096];
+  while (true) {
+    double left = timeout - chrono::duration<double>
+      (chrono::steady_clock::now() - start).count();
+    if (left <= 0) {
+      kill(pid, SIGKILL);
+      killed = true;
+      break;
+    }
+    pollfd p = {fd[0], POLLIN, 0};
+    if (poll(&p, 1, (int) (left * 1000) + 1) <= 0)
+      continue;
+    ssize_t n = read(fd[0], buf, sizeof(buf));
+    if (n <= 0)
+      break;
+    r.out.append(buf, n);
+  }
+  close(fd[0]);
+  int status;
+  rusage ru;
+  wait4(pid, &status, 0, &ru);
+  r.wall = chrono::duration<double>
+    (chrono::steady_clock::now() - start).count();
+  r.rss = ru.ru_maxrss;
+  if (killed)
+    r.status = "timeout";
+  else if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+    r.status = "ok";
+  else if (WIFEXITED(status) && WEXITSTATUS(status) == 2)
+    r.status = "stopped";
+  return r;
+}
+
+// the number after '=' on the first line containing key, or -1
+static long long counter (const string &out, const string &key) {
+  size_t at = out.find(key);
+  if (at == string::npos)
+    return -1;
+  size_t eq = out.find('=', at);
+  size_t eol = out.find('\n', at);
+  if (eq == string::npos || eq > eol)
+    return -1;
+  return atoll(out.c_str() + eq + 1);
+}
+
+// number of variables of a data file
+static int arity (const string &data) {
+  ifstream in(data);
+  string b;
+  int k = 0;
+  in >> b >> k;
+  return k;
+}
+
+static result measure (const string &dir, const string &engine,
+		       const vector<string> &args, const string &data,
+		       int repeats, double timeout) {
+  result res = {engine, data.substr(data.rfind('/') + 1), "ok",
+		0, 0, 0, -1, 0, 0, -1, -1};
+  vector<double> walls;
+  string out;
+  for (int i = 0; i < repeats; ++i) {
+    run r = execute(dir + "/" + engine, args, data, timeout);
+    res.runs++;
+    res.rss = max(res.rss, r.rss);
+    if (r.status != "ok") {
+      res.status = r.status;
+      walls.push_back(r.wall);
+      break;
+    }
+    walls.push_back(r.wall);
+    out = r.out;
+  }
+  sort(walls.begin(), walls.end());
+  res.wall_min = walls.front();
+  res.wall_median = walls[walls.size() / 2];
+  if (res.status != "ok")
+    return res;
+  long long evals = counter(out, "# of evals");
+  long long deltas = counter(out, "# of deltas");
+  if (evals >= 0)
+    res.evals = evals + max(deltas, 0LL);
+  if (res.evals >= 0 && res.wall_median > 0)
+    res.evals_per_s = res.evals / res.wall_median;
+  res.memo = counter(out, "memo size");
+  res.stack = counter(out, "max stack size");
+  if (res.stack < 0)
+    res.stack = counter(out, "max queue size");
+  return res;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static string field (long long n) {
+  return n < 0 ? "" : to_string(n);
+}
+
+static void write_csv (const string &file, const vector<result> &results) {
+  ofstream out(file);
+  out << "engine,data,status,runs,wall_min,wall_median,evals,evals_per_s,"
+      << "peak_rss_kb,memo_size,max_stack" << endl;
+  for (const result &r : results)
+    out << r.engine << "," << r.data << "," << r.status << "," << r.runs
+	<< "," << r.wall_min << "," << r.wall_median << ","
+	<< field(r.evals) << "," << (long long) r.evals_per_s << ","
+	<< r.rss << "," << field(r.memo) << "," << field(r.stack) << endl;
+}
+
+static string json_field (long long n) {
+  return n < 0 ? "null" : to_string(n);
+}
+
+static void write_json (const string &file, const vector<result> &results) {
+  ofstream out(file);
+  out << "[" << endl;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const result &r = results[i];
+    out << "  {\"engine\": \"" << r.engine << "\", \"data\": \"" << r.data
+	<< "\", \"status\": \"" << r.status << "\", \"runs\": " << r.runs
+	<< ", \"wall_min\": " << r.wall_min
+	<< ", \"wall_median\": " << r.wall_median
+	<< ", \"evals\": " << json_field(r.evals)
+	<< ", \"evals_per_s\": " << (long long) r.evals_per_s
+	<< ", \"peak_rss_kb\": " << r.rss
+	<< ", \"memo_size\": " << json_field(r.memo)
+	<< ", \"max_stack\": " << json_field(r.stack) << "}"
+	<< (i+1 < results.size() ? "," : "") << endl;
+  }
+  out << "]" << endl;
+}
+
+// results of a CSV file by engine and data file
+static map<pair<string, string>, result> read_csv (const string &file) {
+  map<pair<string, string>, result> base;
+  ifstream in(file);
+  if (!in) {
+    cerr << "*** cannot read baseline " << file << endl;
+    exit(1);
+  }
+  string line;
+  getline(in, line);
+  while (getline(in, line)) {
+    vector<string> f;
+    for (size_t a = 0, b = 0; b != string::npos; a = b+1) {
+      b = line.find(',', a);
+      f.push_back(line.substr(a, b == string::npos ? b : b-a));
+    }
+    if (f.size() < 11)
+      continue;
+    result r = {f[0], f[1], f[2], atoi(f[3].c_str()),
+		atof(f[4].c_str()), atof(f[5].c_str()),
+		f[6].empty() ? -1 : atoll(f[6].c_str()), atof(f[7].c_str()),
+		atol(f[8].c_str()),
+		f[9].empty() ? -1 : atoll(f[9].c_str()),
+		f[10].empty() ? -1 : atoll(f[10].c_str())};
+    base[{r.engine, r.data}] = r;
+  }
+  return base;
+}
+
+// Times below floor seconds are too noisy to compare.  Evaluations are
+// compared for the deterministic engines only.
+static int compare (const map<pair<string, string>, result> &base,
+		    const vector<result> &results, double threshold,
+		    double floor) {
+  int compared = 0, regressions = 0;
+  cout << endl << "*** regressions above " << threshold << "%:" << endl;
+  for (const result &r : results) {
+    auto it = base.find({r.engine, r.data});
+    if (it == base.end())
+      continue;
+    const result &b = it->second;
+    compared++;
+    if (b.status == "ok" && r.status != "ok") {
+      cout << "    " << r.engine << " " << r.data << ": " << b.status
+	   << " -> " << r.status << endl;
+      regressions++;
+      continue;
+    }
+    if (r.status != "ok" || b.status != "ok")
+      continue;
+    if (max(r.wall_median, b.wall_median) >= floor &&
+	r.wall_median > b.wall_median * (1 + threshold / 100)) {
+      cout << "    " << r.engine << " " << r.data << ": wall "
+	   << b.wall_median << " -> " << r.wall_median << " s (+"
+	   << (int) (100 * (r.wall_median / b.wall_median - 1)) << "%)"
+	   << endl;
+      regressions++;
+    }
+    bool random = r.engine.find("rand") != string::npos ||
+      r.engine.find("proba") != string::npos;
+    if (!random && b.evals > 0 &&
+	r.evals > b.evals * (1 + threshold / 100)) {
+      cout << "    " << r.engine << " " << r.data << ": evals "
+	   << b.evals << " -> " << r.evals << " (+"
+	   << (int) (100 * ((double) r.evals / b.evals - 1)) << "%)" << endl;
+      regressions++;
+    }
+  }
+  cout << "+++ " << regressions << " regressions in " << compared
+       << " comparisons" << endl;
+  return regressions;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// With -c cases, the engines are cross-checked instead of timed: each
+// one solves that many random equations without options and then with
+// the options of every -e in turn, and must give the same answer, such
+// as gyt-all with -u against its memo search.  The programs that print
+// every solution must print the same ones; those that print one must
+// agree on whether there is any, and theirs must solve the equation.
+// Options with --resume are run twice, with a checkpoint file: stopped
+// by SIGTERM as soon as the program catches it, then resumed.  The
+// equations have 2 to 4 variables, up to 4 monomials and B up to 25,
+// so that every run is short; half of them get a pair of
+// interchangeable variables.
+
+static string equation (mt19937 &rng) {
+  const int exps[] = {0, 0, 1, 1, 2, 3};
+  int k = rng() % 3 + 2, m = rng() % 4 + 1;
+  vector<vector<int>> mons;
+  for (int j = 0; j < m; ++j) {
+    vector<int> e(k+1, 0);
+    e[0] = rng() % 3 + 1;
+    while (count(e.begin() + 1, e.end(), 0) == k)
+      for (int i = 1; i <= k; ++i)
+	e[i] = exps[rng() % 6];
+    mons.push_back(e);
+  }
+  if (rng() % 2) {
+    int a = rng() % k + 1, b = rng() % (k-1) + 1;
+    b += b >= a;
+    for (int j = 0; j < m; ++j) {
+      vector<int> e = mons[j];
+      swap(e[a], e[b]);
+      if (find(mons.begin(), mons.end(), e) == mons.end())
+	mons.push_back(e);
+    }
+  }
+  ostringstream out;
+  out << rng() % 25 + 1 << endl << k << endl;
+  for (const vector<int> &e : mons) {
+    for (size_t i = 0; i < e.size(); ++i)
+      out << (i ? " " : "") << e[i];
+    out << endl;
+  }
+  return out.str();
+}
+
+// the solutions printed in out, sorted
+static vector<string> solutions (const string &out) {
+  vector<string> sols;
+  istringstream in(out);
+  bool values = false;
+  for (string line; getline(in, line); )
+    if (line.find("solution for values") != string::npos) {
+      sols.emplace_back();
+      values = true;
+    } else if (values && line.find("x_") != string::npos)
+      sols.back() += line.substr(line.find('=') + 1);
+    else
+      values = false;
+  sort(sols.begin(), sols.end());
+  return sols;
+}
+
+// whether the values of sol solve the equation eq
+static bool solves (const string &eq, const string &sol) {
+  istringstream in(eq), vals(sol);
+  long long B, k, p = 0;
+  in >> B >> k;
+  vector<long long> x(k);
+  for (long long &v : x)
+    vals >> v;
+  if (!vals)
+    return false;
+  for (long long c; in >> c; ) {
+    for (long long i = 0, e; i < k && in >> e; ++i)
+      while (e-- > 0)
+	c *= x[i];
+    p += c;
+  }
+  return p == B;
+}
+
+// whether b answers eq as a does
+static bool agree (const string &eq, const run &a, const run &b) {
+  if (a.status != "ok" || b.status != "ok")
+    return false;
+  vector<string> sa = solutions(a.out), sb = solutions(b.out);
+  if (a.out.find("number of solutions") != string::npos)
+    return sa == sb;
+  return sa.size() == sb.size() && (sb.empty() || solves(eq, sb[0]));
+}
+
+// a run with args, stopped and resumed from file if they hold --resume
+static run execute_resumed (const string &path, const vector<string> &args,
+			    const string &data, double timeout,
+			    const string &file) {
+  if (find(args.begin(), args.end(), "--resume") == args.end())
+    return execute(path, args, data, timeout);
+  vector<string> first = {"-C", file}, again = first;
+  for (const string &a : args) {
+    if (a != "--resume")
+      first.push_back(a);
+    again.push_back(a);
+  }
+  run r = execute(path, first, data, timeout, true);
+  if (r.status == "stopped")
+    r = execute(path, again, data, timeout);
+  unlink(file.c_str());
+  return r;
+}
+
+static int cross_check (const string &dir, const vector<string> &selected,
+			const vector<vector<string>> &variants, int cases,
+			unsigned seed, double timeout) {
+  char file[] = "/tmp/gyt-bench-XXXXXX";
+  int fd = mkstemp(file);
+  if (fd < 0) {
+    cerr << "*** cannot create " << file << endl;
+    exit(1);
+  }
+  close(fd);
+  string checkpoint = string(file) + ".checkpoint";
+  mt19937 rng(seed);
+  int mismatches = 0;
+  for (int c = 0; c < cases; ++c) {
+    string eq = equation(rng);
+    ofstream(file) << eq;
+    for (const string &engine : selected) {
+      string path = dir + "/" + engine;
+      run a = execute(path, {}, file, timeout);
+      for (const vector<string> &args : variants) {
+	run b = execute_resumed(path, args, file, timeout, checkpoint);
+	if (agree(eq, a, b))
+	  continue;
+	mismatches++;
+	string shown = eq.substr(0, eq.size() - 1), opts;
+	replace(shown.begin(), shown.end(), '\n', '/');
+	for (const string &o : args)
+	  opts += " " + o;
+	cout << "    " << engine << " " << shown << ": " << a.status << " "
+	     << solutions(a.out).size() << " solutions, with" << opts << " "
+	     << b.status << " " << solutions(b.out).size() << endl;
+      }
+    }
+  }
+  unlink(file);
+  cout << "+++ " << mismatches << " mismatches in " << cases
+       << " cases of " << variants.size() << " options, seed " << seed
+       << endl;
+  return mismatches;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+  int repeats = 3, cases = 0;
+  unsigned seed = 1;
+  double timeout = 10, threshold = 10, floor = 0.05;
+  string data_dir = "data", prefix = "bench", baseline;
+  vector<string> options;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:t:d:o:b:x:f:e:c:s:")) != -1)
+    if (opt == 'n')
+      repeats = max(1, atoi(optarg));
+    else if (opt == 't')
+      timeout = atof(optarg);
+    else if (opt == 'd')
+      data_dir = optarg;
+    else if (opt == 'o')
+      prefix = optarg;
+    else if (opt == 'b')
+      baseline = optarg;
+    else if (opt == 'x')
+      threshold = atof(optarg);
+    else if (opt == 'f')
+      floor = atof(optarg);
+    else if (opt == 'e')
+      options.push_back(optarg);
+    else if (opt == 'c')
+      cases = max(0, atoi(optarg));
+    else if (opt == 's')
+      seed = strtoul(optarg, nullptr, 10);
+    else {
+      cerr << "usage: " << argv[0] << " [-n repeats] [-t seconds]"
+	   << " [-d data] [-o prefix] [-b baseline.csv] [-x percent]"
+	   << " [-f seconds] [-e options] [-c cases] [-s seed]"
+	   << " [engine ...]" << endl;
+      exit(1);
+    }
+
+  vector<string> selected(argv + optind, argv + argc);
+  if (selected.empty() && cases > 0)
+    selected = {"gyt-all", "gyt-all-gmp"};
+  else if (selected.empty())
+    selected = engines;
+  string dir = argv[0];
+  dir = dir.find('/') == string::npos ? "." : dir.substr(0, dir.rfind('/'));
+  // the options of every -e, and all of them for the timings
+  vector<vector<string>> variants;
+  vector<string> args;
+  for (const string &o : options) {
+    variants.emplace_back();
+    stringstream ss(o);
+    for (string a; ss >> a; ) {
+      variants.back().push_back(a);
+      args.push_back(a);
+    }
+  }
+
+  cout << header << endl;
+  cout << underline << endl;
+  cout << endl;
+
+  if (cases > 0) {
+    vector<string> built;
+    for (const string &engine : selected)
+      if (access((dir + "/" + engine).c_str(), X_OK) == 0)
+	built.push_back(engine);
+      else
+	cout << "*** skipped " << engine << ": not built" << endl;
+    return cross_check(dir, built, variants, cases, seed, timeout) > 0;
+  }
+
+  vector<string> files;
+  if (DIR *d = opendir(data_dir.c_str())) {
+    while (dirent *e = readdir(d)) {
+      string name = e->d_name;
+      if (name.size() > 5 && name.substr(name.size() - 5) == ".data")
+	files.push_back(data_dir + "/" + name);
+    }
+    closedir(d);
+  }
+  sort(files.begin(), files.end());
+
+  map<pair<string, string>, result> base;
+  if (!baseline.empty())
+    base = read_csv(baseline);
+
+  vector<result> results;
+  for (const string &engine : selected) {
+    if (access((dir + "/" + engine).c_str(), X_OK) != 0) {
+      cout << "*** skipped " << engine << ": not built" << endl;
+      continue;
+    }
+    bool two = engine.find("-2d") != string::npos;
+    for (const string &data : files) {
+      if (two && arity(data) != 2)
+	continue;
+      result r = measure(dir, engine, args, data, repeats, timeout);
+      results.push_back(r);
+      cout << "    " << engine << " " << r.data << ": " << r.status << " "
+	   << r.wall_median << " s";
+      if (r.evals >= 0)
+	cout << ", " << (long long) r.evals_per_s << " evals/s";
+      cout << ", " << r.rss << " KB" << endl;
+    }
+  }
+
+  write_csv(prefix + ".csv", results);
+  write_json(prefix + ".json", results);
+  cout << endl << "+++ " << results.size() << " results in " << prefix
+       << ".csv and " << prefix << ".json" << endl;
+
+  if (!baseline.empty() && compare(base, results, threshold, floor) > 0)
+    return 1;
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,64 @@
+#include <gmpxx.h>
+#include "gyt-core.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+// mpz_class
+//
+// Values never overflow and nothing saturates; powers are tabulated
+// for fewer x, as every entry is a number of its own, see max_table().
+
+inline mpz_class mul_sat (const mpz_class &a, const mpz_class &b) {
+  return a * b;
+}
+
+inline mpz_class add_sat (const mpz_class &a, const mpz_class &b) {
+  return a + b;
+}
+
+inline bool saturated (const mpz_class &) {
+  return false;
+}
+
+inline mpz_class iroot (const mpz_class &n, bigint e) {
+  mpz_class root;
+  mpz_root(root.get_mpz_t(), n.get_mpz_t(), e);
+  return root;
+}
+
+inline bool parse (const string &s, mpz_class &x) {
+  x = s;
+  return true;
+}
+
+template <>
+inline void usage_hand_off<mpz_class> (const char *) {}
+
+inline bigint residue (const mpz_class &x, bigint m) {
+  return mpz_fdiv_ui(x.get_mpz_t(), m);
+}
+
+inline mpz_class mul_div (const mpz_class &a, const mpz_class &b,
+			  const mpz_class &c) {
+  return a * b / c;
+}
+
+inline bigint bit_length (const mpz_class &x) {
+  return x == 0 ? 1 : mpz_sizeinbase(x.get_mpz_t(), 2);
+}
+
+inline bigint word (const mpz_class &x, bigint j) {
+  return mpz_getlimbn(x.get_mpz_t(), j);
+}
+
+inline bool from_words (mpz_class &x, const bigint *w, bigint n) {
+  mpz_import(x.get_mpz_t(), n, -1, sizeof(bigint), 0, 0, w);
+  return true;
+}
+
+inline long long as_count (const mpz_class &x) {
+  return x.fits_slong_p() ? x.get_si() : LLONG_MAX;
+}
+
+inline long double as_real (const mpz_class &x) {
+  return x.get_d();
+}
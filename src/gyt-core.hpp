@@ -0,0 +1,2899 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <climits>
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+#include <csignal>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////
+// The search core, for a number type N of the values and coordinates.
+// It is bigint, 64-bit words saturated where they would overflow, or
+// mpz_class, see gyt-core-gmp.hpp.  A number type provides mul_sat(),
+// add_sat(), saturated(), iroot(), parse(), residue(), mul_div(),
+// bit_length(), word(), from_words(), as_count() and as_real(), and the
+// size of its power tables.  Counts, sizes and exponents are bigint in
+// all cases.
+
+typedef unsigned long bigint;	// 64 bits, mixes with mpz_class
+template <typename N> using val_tuple = vector<N>;
+
+const bigint NO_TABLE = ULONG_MAX;
+const bigint OVER = ULONG_MAX;		// saturated value, above any B
+
+// entries of one power table, fewer for numbers allocated one by one
+template <typename N>
+constexpr bigint max_table () {
+  return is_arithmetic<N>::value ? 1 << 20 : 1 << 16;
+}
+
+struct factor {
+  bigint var;
+  bigint exp;			// > 0
+  bigint tab;			// power table of x^exp, or NO_TABLE
+};
+
+template <typename N>
+struct polynomial {
+  bigint k;			// number of variables
+  val_tuple<N> coeffs;		// coefficients
+  vector<vector<bigint>> monomials; // exponents
+  // compiled form, monomials of highest degree first
+  val_tuple<N> ccoeffs;		// coefficients
+  vector<bigint> first;		// monomial i is factors[first[i]..first[i+1])
+  vector<factor> factors;
+  vector<val_tuple<N>> tables;	// x^exp for x = 0..bound[var]
+  bool wide = false;		// p(bound) exceeds 64 bits, see power_tables()
+  // classes of interchangeable variables, see symmetries()
+  vector<bigint> prev;		// previous variable of the class, or k
+  vector<bigint> next;		// next variable of the class, or k
+  vector<vector<bigint>> classes;
+};
+
+// one table of forward differences of x^exp per (variable, exponent) pair
+template <typename N>
+struct power_slot {
+  bigint var;
+  bigint exp;
+  bigint tab;			// power table of the compiled polynomial
+  val_tuple<N> diff;		// diff[d] = d-th difference of x^exp at x
+  bool table;			// diff[1..exp] are valid
+};
+
+// state of the incremental evaluator: the point evaluated last, the
+// value of every monomial there and the power tables they are built of
+template <typename N>
+struct eval_state {
+  val_tuple<N> val;
+  vector<power_slot<N>> slots;
+  vector<vector<bigint>> axis_slots; // slots of each variable
+  vector<vector<bigint>> mono_slots; // slots of each monomial
+  vector<vector<bigint>> users;	     // monomials containing each variable
+  val_tuple<N> terms;
+  N sum;
+  bigint last_axis;		// axis of the last unit step
+};
+
+// blocked Bloom filter: a key sets probes bits of one block of 512 bits,
+// a cache line, picked by its hash
+struct bloom_filter {
+  vector<bigint> bits;
+  bigint blocks = 0;
+  bigint probes = 0;
+};
+
+// sorted packed tuples in a file mapped read-only
+struct memo_run {
+  const bigint *keys = nullptr;
+  bigint count = 0;
+  bloom_filter bloom;
+  vector<bigint> fences;	// first tuple of every page
+};
+
+// runs of a memo spilled to disk, see spill()
+struct spill_tier {
+  string dir;			// none if empty
+  bigint quota = 0;		// bytes on disk, 0 for no bound
+  vector<memo_run> runs;
+  bigint disk = 0;		// bytes of the runs
+  bigint written = 0;
+  bigint read = 0;
+  bigint hits = 0;		// lookups past the table found in a run
+  bigint misses = 0;
+  bigint filtered = 0;		// misses that read no page
+};
+
+// set of tuples packed into fixed-width words, with open addressing;
+// bit 0 of the first word marks a taken slot
+struct tuple_set {
+  vector<bigint> word;		// word and shift of each coordinate
+  vector<bigint> shift;
+  vector<bigint> span;		// words of a coordinate, if more than one
+  vector<bigint> bits;
+  bigint words;			// words per tuple
+  bigint mask;			// number of slots - 1
+  bigint count;
+  vector<bigint> slots;
+  vector<bigint> key;		// scratch
+  vector<bigint> column;	// bits of x_1..x_{k-1}, see init_columns()
+  // bounded memo, see squeeze()
+  bigint limit = 0;		// tuples before a squeeze, 0 for no bound
+  vector<unsigned char> hits;	// nodes that asked, by slot
+  vector<bigint> prev;		// classes of the variables
+  bigint peak = 0;
+  bigint retired = 0;		// dropped as no search asks again
+  bigint evicted = 0;		// dropped all the same
+  bigint shards = 1;		// sets the budget is split between
+  function<bigint (vector<bigint> &)> floor;	// see squeeze()
+  spill_tier spill;
+  // approximate memo, see bloom_insert()
+  double approx = 0;		// bits per tuple, 0 for an exact memo
+  vector<bloom_filter> blooms;
+  bigint capacity = 0;		// tuples the filters are made for
+};
+
+// tuples stored inline, stride numbers each, in one growing buffer; used
+// as a stack, or as a pool of slots recycled through a free list
+template <typename N>
+struct tuple_arena {
+  bigint stride;
+  bigint count;			// tuples on the stack / slots handed out
+  val_tuple<N> data;
+  vector<bigint> free;
+};
+
+// memo shared by several threads: tuple sets selected by a hash of the
+// tuple, each behind its own lock
+struct shared_set {
+  bool shared;			// lock only if used by several threads
+  vector<tuple_set> shard;
+  vector<mutex> locks;
+  shared_set (bigint n) : shard(n), locks(n) {}
+};
+
+// frontier of one thread: the owner works at the top, thieves take the
+// oldest tuples from the bottom
+template <typename N>
+struct work_deque {
+  bool shared;
+  mutex lock;
+  bigint head;			// first tuple not stolen yet
+  tuple_arena<N> a;
+};
+
+// moduli of the residue filter, and for each the masks of residues of
+// x_k that can give B, by the residues of x_1..x_{k-1}
+struct residue_filter {
+  vector<bigint> moduli;
+  vector<vector<bigint>> masks;
+  bool impossible = false;	// no residues give B
+};
+
+extern const string header;
+extern const string underline;
+inline thread_local bigint num_of_evals = 0;
+inline thread_local bigint num_of_deltas = 0;
+inline thread_local long long num_of_saved = 0;
+inline thread_local bigint num_of_cuts = 0;
+inline thread_local bigint num_of_boxes = 0;
+inline thread_local bigint num_of_pruned = 0;
+inline thread_local long double pruned_volume = 0;
+inline thread_local bigint num_of_columns = 0;
+inline thread_local bigint num_of_filtered = 0;
+
+//////////////////////////////////////////////////////////////////////////////
+// bigint
+//
+// B is below 2^64 - 1, so a value that does not fit into 64 bits only
+// has to compare above B: products and sums saturate at OVER instead
+// of wrapping around.
+
+inline bigint mul_sat (bigint a, bigint b) {
+  bigint r;
+  return __builtin_mul_overflow(a, b, &r) ? OVER : r;
+}
+
+inline bigint add_sat (bigint a, bigint b) {
+  bigint r;
+  return __builtin_add_overflow(a, b, &r) ? OVER : r;
+}
+
+inline bool saturated (bigint x) {
+  return x == OVER;
+}
+
+// x^e <= n, without overflow
+inline bool power_fits (bigint x, bigint e, bigint n) {
+  unsigned __int128 r = 1;
+  for (bigint j = 0; j < e; ++j) {
+    r *= x;
+    if (r > n)
+      return false;
+  }
+  return true;
+}
+
+// floor of the e-th root of n, exact: the floating point estimate is
+// corrected by at most a few steps
+inline bigint iroot (bigint n, bigint e) {
+  if (e == 1)
+    return n;
+  if (e >= 64)
+    return n > 0;
+  bigint x = powl((long double) n, 1.0L / e);
+  while (x > 0 && !power_fits(x, e, n))
+    x--;
+  while (power_fits(x+1, e, n))
+    x++;
+  return x;
+}
+
+// false if s does not fit below OVER
+inline bool parse (const string &s, bigint &x) {
+  errno = 0;
+  x = strtoull(s.c_str(), nullptr, 10);
+  return errno != ERANGE && x != OVER;
+}
+
+inline bigint residue (bigint x, bigint m) {
+  return x % m;
+}
+
+// a * b / c, exactly
+inline bigint mul_div (bigint a, bigint b, bigint c) {
+  return (unsigned __int128) a * b / c;
+}
+
+inline bigint bit_length (bigint x) {
+  return 64 - __builtin_clzl(x | 1);
+}
+
+// the j-th word of x, from the least significant one
+inline bigint word (bigint x, bigint j) {
+  return j == 0 ? x : 0;
+}
+
+// x from its n words, false if it does not fit
+inline bool from_words (bigint &x, const bigint *w, bigint n) {
+  x = w[0];
+  return n == 1;
+}
+
+inline long long as_count (bigint x) {
+  return x;
+}
+
+inline long double as_real (bigint x) {
+  return x;
+}
+
+// B does not fit into 64 bits: the whole program is replaced by its
+// multiprecision twin, named with -gmp appended, as it was run or else
+// next to this executable, and given the same arguments, -J and -H
+// included.  The twin reads B and the rest of the input from a pipe,
+// fed by a grandchild, so that the twin has no child of ours to reap.
+inline void hand_off (const string &b) {
+  ifstream in("/proc/self/cmdline");
+  vector<string> args;
+  string arg;
+  while (getline(in, arg, '\0'))
+    args.push_back(arg);
+  if (args.empty()) {
+    cerr << endl << "*** B does not fit into 64 bits and the arguments"
+	 << " cannot be handed to the -gmp program" << endl;
+    exit(1);
+  }
+  args[0] += "-gmp";
+  char exe[4096];
+  ssize_t len = readlink("/proc/self/exe", exe, sizeof exe);
+  string twin = len > 0 ? string(exe, len) + "-gmp" : args[0];
+  vector<char *> argv;
+  for (string &a : args)
+    argv.push_back(&a[0]);
+  argv.push_back(nullptr);
+
+  int fd[2];
+  if (pipe(fd) == 0) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      if (fork() > 0)
+	_exit(0);
+      close(fd[0]);
+      ostringstream rest;
+      rest << b << endl << cin.rdbuf();
+      string s = rest.str();
+      for (size_t n = 0; n < s.size(); ) {
+	ssize_t w = write(fd[1], s.data() + n, s.size() - n);
+	if (w <= 0)
+	  break;
+	n += w;
+      }
+      _exit(0);
+    }
+    if (pid > 0)
+      waitpid(pid, nullptr, 0);
+    dup2(fd[0], 0);
+    close(fd[0]);
+    close(fd[1]);
+    execvp(argv[0], argv.data());
+    if (twin != args[0])
+      execv(twin.c_str(), argv.data());
+  }
+  const char *why = strerror(errno);
+  cerr << endl << "*** B does not fit into 64 bits and " << args[0];
+  if (twin != args[0])
+    cerr << " or " << twin;
+  cerr << " cannot be run: " << why << endl;
+  exit(1);
+}
+
+// a line of the usage on hand_off(), which the twins do not need
+template <typename N>
+void usage_hand_off (const char *program) {
+  cerr << "  a B of more than 64 bits runs " << program << "-gmp instead,"
+       << " with the same arguments" << endl;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+void compile (polynomial<N> &p);
+
+template <typename N>
+void read_input (polynomial<N> &p, N &B) {
+  cerr << "+++ Input B: ";
+  string b;
+  cin >> b;
+  if (!parse(b, B))
+    hand_off(b);
+
+  cout << header << endl;
+  cout << underline << endl;
+  cout << endl;
+  cout << endl << "*** B = " << B << endl;
+  cerr << "+++ Number of variables: ";
+  cin >> p.k;
+  cout << endl << "*** k = " << p.k << endl;
+  cerr << "+++ Monomials in the form 'coefficient exponent ... exponent', ";
+  cerr << "one per line" << endl;
+  cerr << "+++ Terminate with CTRL-D" << endl;
+
+  N temp;
+  while (cin >> temp) {
+    p.coeffs.push_back(temp);
+    vector<bigint> exponents;
+    bigint exp;
+    for (bigint i = 0; i < p.k; ++i) {
+      cin >> exp;
+      exponents.push_back(exp);
+    }
+    p.monomials.push_back(exponents);
+    cerr << "*** monomial = " << temp;
+    for (bigint i = 0; i < p.k; ++i)
+      if (exponents[i] > 0)
+	cerr << " (x_" << i+1 << ")^" << exponents[i];
+    cerr << endl;
+  }
+
+  cout << "*** equation: ";
+  bool plus = false;
+  for (bigint i = 0; i < p.coeffs.size(); ++i) {
+    if (plus)
+      cout << " + ";
+    else
+      plus = true;
+    cout << p.coeffs[i];
+    for (bigint j = 0; j < p.k; ++j)
+      if (p.monomials[i][j] > 0)
+	cout << " (x_" << j+1 << ")^" << p.monomials[i][j];
+  }
+  cout <<  " = " << B << endl;
+
+  compile(p);
+  p.prev.assign(p.k, p.k);
+  p.next.assign(p.k, p.k);
+  p.classes.clear();
+}
+
+template <typename T>
+T power(T x, bigint n) {
+  if (n == 0)
+    return 1;
+  T y = 1;
+  while (n > 1)
+    if (n % 2 == 0) {
+      x *= x;
+      n >>= 1;
+    } else {
+      y *= x;
+      x *= x;
+      n = (n-1)/2;
+    }
+  return x * y;
+}
+
+// x^n, or OVER if it does not fit into 64 bits
+template <typename N>
+N power_sat (N x, bigint n) {
+  N y = 1;
+  for (; n > 0; n >>= 1) {
+    if (n & 1)
+      y = mul_sat(y, x);
+    if (n > 1)
+      x = mul_sat(x, x);
+  }
+  return y;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Compiled polynomial
+//
+// Only the nonzero exponents are kept, as (variable, exponent) factors
+// in one flat array.  Once the bounds are known, x^exp is tabulated for
+// x = 0..bound[var] if the table is not too large.  All coefficients
+// are non-negative, so an evaluation against B may stop as soon as the
+// partial sum exceeds B; monomials of highest degree go first.
+//
+// If p(bound) fits into 64 bits, so does every value in the box of the
+// bounds, and the incremental evaluator keeps its unchecked arithmetic;
+// otherwise the polynomial is wide and it saturates too.
+
+template <typename N>
+void compile (polynomial<N> &p) {
+  vector<bigint> order(p.coeffs.size());
+  vector<bigint> degree(p.coeffs.size(), 0);
+  for (bigint i = 0; i < p.coeffs.size(); ++i) {
+    order[i] = i;
+    for (bigint j = 0; j < p.k; ++j)
+      degree[i] += p.monomials[i][j];
+  }
+  stable_sort(order.begin(), order.end(),
+	      [&](bigint a, bigint b) { return degree[a] > degree[b]; });
+
+  p.ccoeffs.clear();
+  p.first.clear();
+  p.factors.clear();
+  for (bigint i : order) {
+    p.ccoeffs.push_back(p.coeffs[i]);
+    p.first.push_back(p.factors.size());
+    for (bigint j = 0; j < p.k; ++j)
+      if (p.monomials[i][j] > 0)
+	p.factors.push_back({j, p.monomials[i][j], NO_TABLE});
+  }
+  p.first.push_back(p.factors.size());
+}
+
+template <typename N>
+N eval(const polynomial<N> &p, const val_tuple<N> &val);
+
+template <typename N>
+void power_tables (polynomial<N> &p, const val_tuple<N> &bound) {
+  p.tables.clear();
+  for (factor &f : p.factors) {
+    f.tab = NO_TABLE;
+    if (bound[f.var] >= max_table<N>())
+      continue;
+    for (const factor &g : p.factors)
+      if (&g == &f)
+	break;
+      else if (g.var == f.var && g.exp == f.exp) {
+	f.tab = g.tab;
+	break;
+      }
+    if (f.tab != NO_TABLE)
+      continue;
+    f.tab = p.tables.size();
+    bigint n = word(bound[f.var], 0) + 1;
+    p.tables.push_back(val_tuple<N>(n));
+    val_tuple<N> &tab = p.tables.back();
+    for (bigint x = 0; x < n; ++x)
+      tab[x] = power_sat(N(x), f.exp);
+  }
+  p.wide = saturated(eval(p, bound));
+  if (p.wide)
+    cerr << "*** p(bound) exceeds 64 bits, evaluation saturates" << endl;
+}
+
+template <typename N>
+inline N factor_value (const polynomial<N> &p, const factor &f,
+		       const N &x) {
+  if (f.tab != NO_TABLE && x < p.tables[f.tab].size())
+    return p.tables[f.tab][word(x, 0)];
+  return power_sat(x, f.exp);
+}
+
+template <typename N>
+N eval(const polynomial<N> &p, const val_tuple<N> &val) {
+  num_of_evals++;
+  N add = 0, mult;
+  for (bigint i = 0; i < p.ccoeffs.size(); ++i) {
+    mult = p.ccoeffs[i];
+    for (bigint f = p.first[i]; f < p.first[i+1]; ++f)
+      mult = mul_sat(mult, factor_value(p, p.factors[f],
+					val[p.factors[f].var]));
+    add = add_sat(add, mult);
+  }
+  return add;
+}
+
+// the result is exact up to B, any value above B only means "too large"
+template <typename N>
+N eval(const polynomial<N> &p, const val_tuple<N> &val, const N &B) {
+  num_of_evals++;
+  N add = 0, mult;
+  for (bigint i = 0; i < p.ccoeffs.size(); ++i) {
+    mult = p.ccoeffs[i];
+    for (bigint f = p.first[i]; f < p.first[i+1]; ++f)
+      mult = mul_sat(mult, factor_value(p, p.factors[f],
+					val[p.factors[f].var]));
+    add = add_sat(add, mult);
+    if (add > B)
+      break;
+  }
+  return add;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Incremental evaluation
+//
+// Consecutive points of a search differ mostly in one coordinate by 1.
+// Every monomial keeps its value and every (variable, exponent) pair
+// its current power, so that a move along an axis only recomputes the
+// monomials containing that variable.  Powers are looked up in the
+// power tables of the compiled polynomial; where there is no table, a
+// table of forward differences of x^exp makes a unit step cost exp
+// additions.  It is built lazily, on the second consecutive step along
+// the same axis.  Wide polynomials do without the differences, which
+// would wrap around.
+
+template <typename N>
+void init_state (const polynomial<N> &p, eval_state<N> &es) {
+  es.axis_slots.assign(p.k, vector<bigint>());
+  es.users.assign(p.k, vector<bigint>());
+  es.mono_slots.assign(p.ccoeffs.size(), vector<bigint>());
+  for (bigint i = 0; i < p.ccoeffs.size(); ++i)
+    for (bigint f = p.first[i]; f < p.first[i+1]; ++f) {
+      const factor &fc = p.factors[f];
+      bigint s = 0;
+      while (s < es.slots.size() &&
+	     (es.slots[s].var != fc.var || es.slots[s].exp != fc.exp))
+	s++;
+      if (s == es.slots.size()) {
+	es.slots.push_back({fc.var, fc.exp, fc.tab,
+			    val_tuple<N>(fc.exp+1), false});
+	es.axis_slots[fc.var].push_back(s);
+      }
+      es.mono_slots[i].push_back(s);
+      es.users[fc.var].push_back(i);
+    }
+  es.terms.assign(p.ccoeffs.size(), 0);
+}
+
+template <typename N>
+void build_table (power_slot<N> &ps, const N &x) {
+  for (bigint j = 0; j <= ps.exp; ++j)
+    ps.diff[j] = power<N>(x + j, ps.exp);
+  for (bigint d = 1; d <= ps.exp; ++d)
+    for (bigint j = ps.exp; j >= d; --j)
+      ps.diff[j] -= ps.diff[j-1];
+  ps.table = true;
+}
+
+template <typename N>
+inline bool lookup (const polynomial<N> &p, power_slot<N> &ps, const N &x) {
+  if (ps.tab == NO_TABLE || x >= p.tables[ps.tab].size())
+    return false;
+  ps.diff[0] = p.tables[ps.tab][word(x, 0)];
+  ps.table = false;
+  return true;
+}
+
+template <typename N>
+inline N term (const polynomial<N> &p, const eval_state<N> &es, bigint m) {
+  N mult = p.ccoeffs[m];
+  if (p.wide)
+    for (bigint s : es.mono_slots[m])
+      mult = mul_sat(mult, es.slots[s].diff[0]);
+  else
+    for (bigint s : es.mono_slots[m])
+      mult *= es.slots[s].diff[0];
+  return mult;
+}
+
+template <typename N>
+inline void add_terms (eval_state<N> &es) {
+  es.sum = 0;
+  for (const N &t : es.terms)
+    es.sum = add_sat(es.sum, t);
+}
+
+template <typename N>
+N full_eval (const polynomial<N> &p, eval_state<N> &es,
+	     const val_tuple<N> &val) {
+  num_of_evals++;
+  es.val = val;
+  for (power_slot<N> &ps : es.slots)
+    if (!lookup(p, ps, val[ps.var])) {
+      ps.diff[0] = power_sat(val[ps.var], ps.exp);
+      ps.table = false;
+    }
+  for (bigint m = 0; m < p.ccoeffs.size(); ++m)
+    es.terms[m] = term(p, es, m);
+  add_terms(es);
+  es.last_axis = p.k;
+  return es.sum;
+}
+
+template <typename N>
+void move_axis (const polynomial<N> &p, eval_state<N> &es,
+		bigint i, const N &x) {
+  bool up = x == es.val[i]+1;
+  bool down = x+1 == es.val[i];
+  for (bigint s : es.axis_slots[i]) {
+    power_slot<N> &ps = es.slots[s];
+    if (lookup(p, ps, x))
+      continue;
+    if (up && ps.table)
+      for (bigint d = 0; d < ps.exp; ++d)
+	ps.diff[d] += ps.diff[d+1];
+    else if (down && ps.table)
+      for (bigint d = ps.exp; d-- > 0; )
+	ps.diff[d] -= ps.diff[d+1];
+    else if ((up || down) && es.last_axis == i && !p.wide)
+      build_table(ps, x);
+    else {
+      ps.diff[0] = power_sat(x, ps.exp);
+      ps.table = false;
+    }
+  }
+  es.val[i] = x;
+  es.last_axis = up || down ? i : p.k;
+  for (bigint m : es.users[i]) {
+    N t = term(p, es, m);
+    es.sum += t - es.terms[m];
+    es.terms[m] = t;
+  }
+  if (p.wide)
+    add_terms(es);
+}
+
+template <typename N>
+N eval(const polynomial<N> &p, eval_state<N> &es, const val_tuple<N> &val) {
+  if (es.val.empty()) {
+    init_state(p, es);
+    return full_eval(p, es, val);
+  }
+  bigint moved = 0;
+  bigint axis[2];
+  for (bigint j = 0; j < p.k; ++j)
+    if (val[j] != es.val[j]) {
+      if (moved == 2)
+	return full_eval(p, es, val);
+      axis[moved++] = j;
+    }
+  num_of_deltas++;
+  for (bigint t = 0; t < moved; ++t)
+    move_axis(p, es, axis[t], val[axis[t]]);
+  return es.sum;
+}
+
+// bound[i] is the largest x with p(x e_i) <= B.  Every monomial in x_i
+// alone gives an upper bound c x^e <= B, and the largest x is found by
+// binary search below the least of them.  Without such a monomial p is
+// constant along x_i, which is then bounded by the largest x_i that a
+// monomial holding it admits, so that interchangeable variables get the
+// same bound.
+template <typename N>
+val_tuple<N> get_bounds (const polynomial<N> &p, const N &B) {
+  auto start = chrono::steady_clock::now();
+  val_tuple<N> bound;
+  val_tuple<N> hi(p.k), cap(p.k, 0);
+  vector<bool> alone(p.k, false);
+  N q, root;
+  for (bigint j = 0; j < p.monomials.size(); ++j) {
+    bigint vars = 0;
+    for (bigint i = 0; i < p.k; ++i)
+      vars += p.monomials[j][i] > 0;
+    for (bigint i = 0; i < p.k; ++i)
+      if (p.monomials[j][i] > 0) {
+	q = B/p.coeffs[j];
+	root = iroot(q, p.monomials[j][i]);
+	if (root > cap[i])
+	  cap[i] = root;
+	if (vars == 1 && (!alone[i] || root < hi[i]))
+	  hi[i] = root;
+	alone[i] = alone[i] || vars == 1;
+      }
+  }
+
+  for (bigint i = 0; i < p.k; ++i) {
+    if (!alone[i])
+      hi[i] = cap[i] + 1;
+    val_tuple<N> val(p.k, 0);
+    N lo = 0;
+    if (eval(p, val, B) > B)
+      hi[i] = 0;
+    while (lo < hi[i]) {
+      val[i] = lo + (hi[i] - lo + 1) / 2;
+      if (eval(p, val, B) <= B)
+	lo = val[i];
+      else
+	hi[i] = val[i] - 1;
+    }
+    bound.push_back(lo);
+  }
+
+  auto usecs = chrono::duration_cast<chrono::microseconds>
+    (chrono::steady_clock::now() - start).count();
+  for (bigint i = 0; i < bound.size(); ++i)
+    cerr << "*** bound[" << i+1 << "] = " << bound[i] << endl;
+  cerr << "*** bounds computed in " << usecs << " us" << endl;
+  cerr << endl;
+
+  return bound;
+}
+
+template <typename N>
+bool test_bound (const val_tuple<N> &val, const val_tuple<N> &bound,
+		 bigint k) {
+  for (bigint i = 0; i < k; ++i)
+    if (val[i] > bound[i])
+      return false;
+  return true;
+}
+
+// Largest c <= column with p(row, c) < B, by binary search on the
+// monotone row; false if there is none.  This is the column at which
+// the staircase walk of two variables leaves the row.
+template <typename N>
+bool leave_column (const polynomial<N> &p, const N &B,
+		   const N &row, N &column) {
+  val_tuple<N> val = {row, 0};
+  if (eval(p, val, B) >= B)
+    return false;
+  N lo = 0, hi = column;
+  while (lo < hi) {
+    val[1] = lo + (hi - lo + 1) / 2;
+    if (eval(p, val, B) < B)
+      lo = val[1];
+    else
+      hi = val[1] - 1;
+  }
+  column = lo;
+  return true;
+}
+
+// Moves val[i] towards to, down to the first x with p(val) <= B or up
+// to the first x with p(val) >= B, in steps of 1, 2, 4, ... and then by
+// bisection, since p is monotone in x_i; false if there is no such x up
+// to to.  This replaces a run of unit steps, each evaluated, by about
+// twice the logarithm of its length; the difference is added up in
+// num_of_saved.  result is set to p(val) at the point reached, which is
+// also left in es.
+template <typename N>
+bool gallop (const polynomial<N> &p, eval_state<N> &es, val_tuple<N> &val,
+	     bigint i, const N &to, const N &B, N &result) {
+  const bool down = to < val[i];
+  const N x0 = val[i];
+  N a = x0, b, step = 1, dist;
+  long long probes = 0;
+  while (true) {
+    dist = down ? N(a - to) : N(to - a);
+    if (dist == 0) {
+      num_of_saved += as_count(down ? N(x0 - to) : N(to - x0)) - probes;
+      return false;
+    }
+    if (dist <= step)
+      val[i] = to;
+    else if (down)
+      val[i] = a - step;
+    else
+      val[i] = a + step;
+    result = eval(p, es, val);
+    probes++;
+    if (down ? result <= B : result >= B)
+      break;
+    a = val[i];
+    step *= 2;
+  }
+  b = val[i];
+  while ((down ? N(a - b) : N(b - a)) > 1) {
+    if (down)
+      val[i] = b + (a - b) / 2;
+    else
+      val[i] = a + (b - a) / 2;
+    result = eval(p, es, val);
+    probes++;
+    if (down ? result <= B : result >= B)
+      b = val[i];
+    else
+      a = val[i];
+  }
+  if (val[i] != b) {
+    val[i] = b;
+    result = eval(p, es, val);
+    probes++;
+  }
+  num_of_saved += as_count(down ? N(x0 - b) : N(b - x0)) - probes;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Symmetry
+//
+// Two variables are interchangeable if swapping their exponents maps
+// the monomials with their coefficients onto themselves.  Such swaps
+// compose, so the variables fall into classes on which every permutation
+// is a symmetry, and it suffices to search the canonical tuples, with
+// x_a <= x_b for a < b in the same class.  Every class is kept as a chain
+// of neighbours prev[i] < i < next[i]; k stands for none.
+
+template <typename N>
+bool interchangeable (const polynomial<N> &p, bigint a, bigint b) {
+  vector<pair<N, vector<bigint>>> mono, swapped;
+  for (bigint i = 0; i < p.coeffs.size(); ++i) {
+    mono.push_back({p.coeffs[i], p.monomials[i]});
+    swapped.push_back(mono.back());
+    swap(swapped.back().second[a], swapped.back().second[b]);
+  }
+  sort(mono.begin(), mono.end());
+  sort(swapped.begin(), swapped.end());
+  return mono == swapped;
+}
+
+template <typename N>
+void symmetries (polynomial<N> &p) {
+  vector<bool> done(p.k, false);
+  for (bigint a = 0; a < p.k; ++a) {
+    if (done[a])
+      continue;
+    vector<bigint> cls(1, a);
+    for (bigint b = a+1; b < p.k; ++b)
+      if (!done[b] && interchangeable(p, a, b)) {
+	done[b] = true;
+	p.prev[b] = cls.back();
+	p.next[cls.back()] = b;
+	cls.push_back(b);
+      }
+    if (cls.size() > 1)
+      p.classes.push_back(cls);
+  }
+
+  for (const vector<bigint> &cls : p.classes) {
+    cout << "*** symmetric:";
+    for (bigint i : cls)
+      cout << " x_" << i+1;
+    cout << endl;
+  }
+}
+
+// val + e_i is canonical if val is
+template <typename N>
+bool canonical_step (const polynomial<N> &p, const val_tuple<N> &val,
+		     bigint i) {
+  return p.next[i] == p.k || val[i] < val[p.next[i]];
+}
+
+// val + e_i is reached from val alone: the parent of a tuple lowers the
+// first of x_1..x_{k-1} that is not 0, which leaves a canonical tuple
+// canonical, so every tuple has one parent and no memo is needed
+template <typename N>
+bool unique_step (const val_tuple<N> &val, bigint i) {
+  for (bigint j = 0; j < i; ++j)
+    if (val[j] > 0)
+      return false;
+  return true;
+}
+
+// val is canonical if val + e_{k-1} is; x_k is the one that decreases
+template <typename N>
+bool canonical_column (const polynomial<N> &p, const val_tuple<N> &val) {
+  bigint i = p.k-1;
+  return p.prev[i] == p.k || val[p.prev[i]] <= val[i];
+}
+
+// lowest canonical value of x_k for the other coordinates of val
+template <typename N>
+N column_floor (const polynomial<N> &p, const val_tuple<N> &val) {
+  bigint i = p.k-1;
+  return p.prev[i] == p.k ? N(0) : val[p.prev[i]];
+}
+
+// the distinct permutations of a canonical tuple within the classes
+template <typename N>
+void expand (const polynomial<N> &p, const val_tuple<N> &val,
+	     vector<val_tuple<N>> &out) {
+  out.assign(1, val);
+  for (const vector<bigint> &cls : p.classes) {
+    bigint n = out.size();
+    for (bigint j = 0; j < n; ++j) {
+      val_tuple<N> v = out[j];
+      val_tuple<N> x;
+      for (bigint i : cls)
+	x.push_back(v[i]);
+      while (next_permutation(x.begin(), x.end())) {
+	for (bigint i = 0; i < cls.size(); ++i)
+	  v[cls[i]] = x[i];
+	out.push_back(v);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Limits of the subtrees
+//
+// The subtree of val holds tuples >= val in x_1..x_{k-1}, with x_k at
+// least column_floor.  If p(val + e_i) > B at the floor, by monotony no
+// tuple of the subtree with x_i > val[i] fits under B.  Every node
+// carries these limits lim of x_1..x_{k-1}, which start at the bounds
+// and are passed on to its children, so that no child beyond them is
+// evaluated, pushed or memoized anywhere below the node that found one.
+
+// a node is val followed by lim, 2k-1 numbers
+template <typename N>
+void pack_node (const polynomial<N> &p, const val_tuple<N> &val,
+		const val_tuple<N> &lim, N *node) {
+  copy(val.begin(), val.begin() + p.k, node);
+  copy(lim.begin(), lim.begin() + p.k-1, node + p.k);
+}
+
+template <typename N>
+void unpack_node (const polynomial<N> &p, const N *node,
+		  val_tuple<N> &val, val_tuple<N> &lim) {
+  copy(node, node + p.k, val.begin());
+  copy(node + p.k, node + 2*p.k-1, lim.begin());
+}
+
+// valx = val + e_i; lowers lim[i] to val[i] if valx cannot fit.  The
+// test costs one step of the evaluator where x_k is at the floor
+// already; above it the child is left to the walk.
+template <typename N>
+bool child_fits (const polynomial<N> &p, eval_state<N> &es, const N &B,
+		 const val_tuple<N> &valx, val_tuple<N> &lim, bigint i) {
+  if (valx[i] > lim[i])
+    return false;
+  if (valx[p.k-1] != column_floor(p, valx) || eval(p, es, valx) <= B)
+    return true;
+  lim[i] = valx[i] - 1;
+  num_of_cuts++;
+  return false;
+}
+
+// valx = val + e_i where p(val) = B: valx is a solution too if p does
+// not grow along x_i there, and then its column has to be entered at
+// this x_k, as the point below B that ends the walk may be too low.  A
+// search for all solutions pushes every child once per walk, from the
+// highest point that needs it.
+template <typename N>
+bool solution_step (const polynomial<N> &p, eval_state<N> &es, const N &B,
+		    const val_tuple<N> &valx, const val_tuple<N> &lim,
+		    bigint i) {
+  return valx[i] <= lim[i] && eval(p, es, valx) == B;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Boxes
+//
+// p is non-decreasing in every variable, so over the box lo <= x <= hi
+// it ranges from p(lo) to p(hi), and no tuple of the box reaches B if
+// p(lo) > B or p(hi) < B.
+
+template <typename N>
+bool prune_box (const polynomial<N> &p, const N &B,
+		const val_tuple<N> &lo, const val_tuple<N> &hi) {
+  num_of_boxes++;
+  if (eval(p, lo, B) <= B && eval(p, hi, B) >= B)
+    return false;
+  num_of_pruned++;
+  long double volume = 1;
+  for (bigint i = 0; i < p.k; ++i)
+    volume *= as_real(N(hi[i] - lo[i])) + 1.0L;
+  pruned_volume += volume;
+  return true;
+}
+
+// the box of the subtree of a node: x_1..x_{k-1} from val up to lim,
+// x_k from the floor up to val[k-1]
+template <typename N>
+bool prune_node (const polynomial<N> &p, const N &B, const val_tuple<N> &val,
+		 const val_tuple<N> &lim, val_tuple<N> &lo,
+		 val_tuple<N> &hi) {
+  lo = val;
+  lo[p.k-1] = column_floor(p, val);
+  copy(lim.begin(), lim.begin() + p.k-1, hi.begin());
+  hi[p.k-1] = val[p.k-1];
+  return lo[p.k-1] <= hi[p.k-1] && prune_box(p, B, lo, hi);
+}
+
+// shrinks the box to its canonical tuples, false if there are none
+template <typename N>
+bool canonical_box (const polynomial<N> &p, val_tuple<N> &lo,
+		    val_tuple<N> &hi) {
+  for (bigint i = 0; i < p.k; ++i)
+    if (p.prev[i] != p.k)
+      lo[i] = max(lo[i], lo[p.prev[i]]);
+  for (bigint i = p.k; i-- > 0; )
+    if (p.next[i] != p.k)
+      hi[i] = min(hi[i], hi[p.next[i]]);
+  for (bigint i = 0; i < p.k; ++i)
+    if (lo[i] > hi[i])
+      return false;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Residues
+//
+// p(x) = B implies p(x) = B (mod m).  For a few small moduli m, the
+// residues of x_k that can satisfy this are tabulated as a bit mask for
+// every combination of residues of x_1..x_{k-1}.  A column with an empty
+// mask for some m holds no solution, whatever the range of x_k; if the
+// mask is empty everywhere, there is no solution at all.  The moduli
+// are kept only if their table is small and rules out something.
+
+inline bigint power_mod (bigint x, bigint e, bigint m) {
+  bigint y = 1 % m;
+  for (x %= m; e > 0; e >>= 1, x = x * x % m)
+    if (e & 1)
+      y = y * x % m;
+  return y;
+}
+
+template <typename N>
+void init_filter (residue_filter &f, const polynomial<N> &p, const N &B) {
+  static const bigint moduli[] = {16, 9, 5, 7, 11, 13};
+  const bigint MAX_CELLS = 1 << 16;
+  f.moduli.clear();
+  f.masks.clear();
+  f.impossible = false;
+  for (bigint m : moduli) {
+    bigint cells = 1;
+    for (bigint i = 0; i < p.k && cells <= MAX_CELLS; ++i)
+      cells *= m;
+    if (cells > MAX_CELLS)
+      continue;
+    // pw[j][i][r] = residue of the factor x_i^e of monomial j at x_i = r
+    vector<vector<vector<bigint>>>
+      pw(p.coeffs.size(), vector<vector<bigint>>(p.k, vector<bigint>(m)));
+    for (bigint j = 0; j < p.coeffs.size(); ++j)
+      for (bigint i = 0; i < p.k; ++i)
+	for (bigint r = 0; r < m; ++r)
+	  pw[j][i][r] = power_mod(r, p.monomials[j][i], m);
+    vector<bigint> mask(cells / m, 0), res(p.k, 0);
+    bool rules_out = false, any = false;
+    for (bigint c = 0; c < cells; ++c) {
+      for (bigint i = 0, r = c; i < p.k; ++i, r /= m)
+	res[i] = r % m;
+      bigint sum = 0;
+      for (bigint j = 0; j < p.coeffs.size(); ++j) {
+	bigint t = residue(p.coeffs[j], m);
+	for (bigint i = 0; i < p.k; ++i)
+	  t = t * pw[j][i][res[i]] % m;
+	sum += t;
+      }
+      if (sum % m == residue(B, m)) {
+	mask[c % (cells / m)] |= 1UL << res[p.k-1];
+	any = true;
+      } else
+	rules_out = true;
+    }
+    if (!rules_out)
+      continue;
+    f.moduli.push_back(m);
+    f.masks.push_back(mask);
+    f.impossible = f.impossible || !any;
+  }
+}
+
+template <typename N>
+bool column_possible (const residue_filter &f, const polynomial<N> &p,
+		      const val_tuple<N> &val) {
+  if (f.moduli.empty())
+    return true;
+  num_of_columns++;
+  for (bigint j = 0; j < f.moduli.size(); ++j) {
+    bigint m = f.moduli[j], c = 0;
+    for (bigint i = p.k-1; i-- > 0; )
+      c = c * m + residue(val[i], m);
+    if (f.masks[j][c] == 0) {
+      num_of_filtered++;
+      return false;
+    }
+  }
+  return true;
+}
+
+// with x_k in a column without solutions, the walk down the column is
+// skipped if some x_k above the floor is below B, where result is set;
+// the children then start from val[k-1] instead of the column's end
+template <typename N>
+bool skip_column (const polynomial<N> &p, eval_state<N> &es,
+		  const residue_filter &f, const N &B,
+		  val_tuple<N> &val, N &result) {
+  if (column_possible(f, p, val))
+    return false;
+  N column = val[p.k-1];
+  val[p.k-1] = column_floor(p, val);
+  N floor = eval(p, es, val);
+  val[p.k-1] = column;
+  if (floor >= B)
+    return false;
+  result = floor;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Memo
+//
+// All coordinates are bounded, so a tuple packs into a few words with
+// as many bits per coordinate as its bound needs; a coordinate wider
+// than a word spans whole words.  The packed tuples live in one flat
+// array, hashed with linear probing, at most half full.
+
+template <typename N>
+void init_set (tuple_set &s, const val_tuple<N> &bound) {
+  s.word.clear();
+  s.shift.clear();
+  s.span.clear();
+  s.bits.clear();
+  bigint w = 0, used = 1;
+  for (const N &b : bound) {
+    bigint bits = bit_length(b);
+    if (used + bits > 64) {
+      w++;
+      used = 0;
+    }
+    s.word.push_back(w);
+    s.shift.push_back(used);
+    s.span.push_back(1);
+    s.bits.push_back(bits);
+    used += bits;
+    if (bits > 64) {
+      s.span.back() = (bits + 63) / 64;
+      w += s.span.back() - 1;
+      used = 64;
+    }
+  }
+  s.words = w+1;
+  s.mask = 15;
+  s.count = 0;
+  s.peak = s.retired = s.evicted = 0;
+  s.slots.assign((s.mask+1) * s.words, 0);
+  s.key.assign(s.words, 0);
+  s.column.clear();
+}
+
+template <typename N>
+inline void pack (tuple_set &s, const N *val) {
+  fill(s.key.begin(), s.key.end(), 0);
+  s.key[0] = 1;
+  for (bigint i = 0; i < s.word.size(); ++i)
+    if (s.span[i] == 1)
+      s.key[s.word[i]] |= word(val[i], 0) << s.shift[i];
+    else
+      for (bigint j = 0; j < s.span[i]; ++j)
+	s.key[s.word[i] + j] = word(val[i], j);
+}
+
+inline bigint hash_key (const bigint *key, bigint words) {
+  bigint h = 0;
+  for (bigint w = 0; w < words; ++w)
+    h = (h ^ key[w]) * 0x9e3779b97f4a7c15UL;
+  h ^= h >> 29;
+  h *= 0xbf58476d1ce4e5b9UL;
+  return h ^ (h >> 32);
+}
+
+// With the residue filter, a column may be entered at several x_k, see
+// skip_column().  The memo then knows a tuple by x_1..x_{k-1} alone and
+// keeps the highest x_k the column was entered at, so that a higher
+// entry is searched again, see column_done(); runs on disk keep whole
+// tuples.
+inline void init_columns (tuple_set &s) {
+  bigint i = s.word.size() - 1;
+  s.column.assign(s.words, ~0UL);
+  for (bigint j = 0; j < s.span[i]; ++j)
+    s.column[s.word[i] + j] = 0;
+  if (s.span[i] == 1 && s.bits[i] < 64)
+    s.column[s.word[i]] = ~(((1UL << s.bits[i]) - 1) << s.shift[i]);
+}
+
+inline bigint table_hash (const tuple_set &s, const bigint *key) {
+  if (s.column.empty())
+    return hash_key(key, s.words);
+  bigint h = 0;
+  for (bigint w = 0; w < s.words; ++w)
+    h = (h ^ (key[w] & s.column[w])) * 0x9e3779b97f4a7c15UL;
+  h ^= h >> 29;
+  h *= 0xbf58476d1ce4e5b9UL;
+  return h ^ (h >> 32);
+}
+
+inline bool same_key (const tuple_set &s, const bigint *a, const bigint *b) {
+  if (s.column.empty())
+    return equal(a, a + s.words, b);
+  for (bigint w = 0; w < s.words; ++w)
+    if ((a[w] ^ b[w]) & s.column[w])
+      return false;
+  return true;
+}
+
+// whether the tuple in slot was entered at key's x_k or above; x_k
+// comes last, so its words compare from the last one
+inline bool covers (const tuple_set &s, const bigint *slot, const bigint *key) {
+  if (s.column.empty())
+    return true;
+  for (bigint w = s.words; w-- > 0; ) {
+    bigint a = slot[w] & ~s.column[w], b = key[w] & ~s.column[w];
+    if (a != b)
+      return a > b;
+  }
+  return true;
+}
+
+// slot holding the key, or the empty slot where it belongs
+inline bigint probe (const tuple_set &s, const bigint *key) {
+  bigint h = table_hash(s, key) & s.mask;
+  for (;;) {
+    const bigint *slot = &s.slots[h * s.words];
+    if (slot[0] == 0 || same_key(s, key, slot))
+      return h;
+    h = (h+1) & s.mask;
+  }
+}
+
+inline void grow (tuple_set &s) {
+  vector<bigint> old;
+  vector<unsigned char> hits;
+  old.swap(s.slots);
+  hits.swap(s.hits);
+  s.mask = 2*s.mask + 1;
+  s.slots.assign((s.mask+1) * s.words, 0);
+  if (!hits.empty())
+    s.hits.assign(s.mask+1, 0);
+  for (bigint i = 0; i < old.size(); i += s.words)
+    if (old[i] != 0) {
+      bigint h = probe(s, &old[i]);
+      copy(&old[i], &old[i] + s.words, &s.slots[h * s.words]);
+      if (!hits.empty())
+	s.hits[h] = hits[i / s.words];
+    }
+}
+
+// sorts records of words key words and a payload by their keys, 8 bits
+// a pass from the last word up; bytes equal in all keys are skipped
+inline void radix_sort (vector<bigint> &recs, vector<bigint> &tmp,
+			bigint words) {
+  const bigint stride = words+1, n = recs.size() / stride;
+  bigint count[256];
+  tmp.resize(recs.size());
+  for (bigint w = words; w-- > 0; ) {
+    bigint diff = 0;
+    for (bigint j = 1; j < n; ++j)
+      diff |= recs[j * stride + w] ^ recs[w];
+    for (bigint shift = 0; shift < 64; shift += 8) {
+      if ((diff >> shift & 255) == 0)
+	continue;
+      fill(count, count + 256, 0);
+      for (bigint j = 0; j < n; ++j)
+	count[recs[j * stride + w] >> shift & 255]++;
+      for (bigint d = 0, sum = 0; d < 256; ++d) {
+	bigint c = count[d];
+	count[d] = sum;
+	sum += c;
+      }
+      for (bigint j = 0; j < n; ++j) {
+	bigint &at = count[recs[j * stride + w] >> shift & 255];
+	copy(&recs[j * stride], &recs[(j+1) * stride], &tmp[at * stride]);
+	at++;
+      }
+      recs.swap(tmp);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Memo on disk
+//
+// Given a directory, a bounded memo spills the tuples it would evict to
+// a run instead: a file of sorted packed tuples, mapped read-only and
+// unlinked at once, so that it goes away with the process.  Every run
+// keeps in memory a blocked Bloom filter of BLOOM_BITS bits per tuple
+// and the first tuple of each of its pages, the fences, so that a
+// lookup missing the table reads at most one page of every run whose
+// filter lets the tuple pass, and most misses read none.  Beyond
+// MAX_RUNS runs, all of them are merged into one.  Runs are never
+// erased, so their tuples are not retired.  Once the runs would exceed
+// the quota, the memo evicts as without a directory.
+
+const double BLOOM_BITS = 10;	// bits per tuple of a run's filter
+const bigint MAX_RUNS = 8;
+const bigint PAGE_BYTES = 4096;
+
+// a filter for n keys of bits bits each
+inline void init_bloom (bloom_filter &b, bigint n, double bits) {
+  b.blocks = max(1.0, ceil(n * bits / 512));
+  b.bits.assign(8 * b.blocks, 0);
+  b.probes = max(1.0, round(bits * log(2)));
+}
+
+// the probes bits of hash h are drawn 9 at a time from a multiplicative
+// sequence started at h, in the block h picks
+inline void bloom_add (bloom_filter &b, bigint h) {
+  bigint *block = &b.bits[8 * (h % b.blocks)];
+  for (bigint i = 0; i < b.probes; ++i) {
+    h = h * 0x9e3779b97f4a7c15UL + 1;
+    block[h >> 61] |= 1UL << (h >> 55 & 63);
+  }
+}
+
+inline bool bloom_test (const bloom_filter &b, bigint h) {
+  const bigint *block = &b.bits[8 * (h % b.blocks)];
+  for (bigint i = 0; i < b.probes; ++i) {
+    h = h * 0x9e3779b97f4a7c15UL + 1;
+    if ((block[h >> 61] >> (h >> 55 & 63) & 1) == 0)
+      return false;
+  }
+  return true;
+}
+
+inline void spill_failed (const string &dir) {
+  cerr << "*** cannot spill the memo to " << dir << ": "
+       << strerror(errno) << endl;
+  exit(1);
+}
+
+inline bigint page_tuples (const tuple_set &s) {
+  return max(1UL, PAGE_BYTES / (s.words * sizeof(bigint)));
+}
+
+// writes the n tuples given in order by next() to a new run of s
+inline void add_run (tuple_set &s, bigint n,
+		     const function<const bigint *()> &next) {
+  spill_tier &t = s.spill;
+  string path = t.dir + "/gyt-memo-XXXXXX";
+  int fd = mkstemp(&path[0]);
+  if (fd < 0)
+    spill_failed(t.dir);
+  unlink(path.c_str());
+  memo_run r;
+  r.count = n;
+  init_bloom(r.bloom, n, BLOOM_BITS);
+  const bigint page = page_tuples(s), bytes = n * s.words * sizeof(bigint);
+  vector<bigint> buf;
+  for (bigint j = 0; j < n; ++j) {
+    const bigint *key = next();
+    bloom_add(r.bloom, hash_key(key, s.words));
+    if (j % page == 0)
+      r.fences.insert(r.fences.end(), key, key + s.words);
+    buf.insert(buf.end(), key, key + s.words);
+    if (buf.size() < (1 << 16) && j+1 < n)
+      continue;
+    const char *at = (const char *) buf.data();
+    for (bigint left = buf.size() * sizeof(bigint); left > 0; ) {
+      ssize_t done = write(fd, at, left);
+      if (done < 0 && errno == EINTR)
+	continue;
+      if (done <= 0)
+	spill_failed(t.dir);
+      at += done;
+      left -= done;
+    }
+    buf.clear();
+  }
+  void *keys = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  if (keys == MAP_FAILED)
+    spill_failed(t.dir);
+  close(fd);
+  r.keys = (const bigint *) keys;
+  t.runs.push_back(move(r));
+  t.disk += bytes;
+  t.written += bytes;
+}
+
+inline bool key_less (const bigint *a, const bigint *b, bigint words) {
+  return lexicographical_compare(a, a + words, b, b + words);
+}
+
+// merges all runs of s into one, if the quota leaves room for both
+inline void merge_runs (tuple_set &s) {
+  spill_tier &t = s.spill;
+  if (t.quota != 0 && 2 * t.disk > t.quota)
+    return;
+  vector<memo_run> runs;
+  runs.swap(t.runs);
+  vector<bigint> at(runs.size(), 0);
+  bigint n = 0, disk = t.disk;
+  for (const memo_run &r : runs)
+    n += r.count;
+  add_run(s, n, [&]() {
+    bigint best = runs.size();
+    for (bigint i = 0; i < runs.size(); ++i)
+      if (at[i] < runs[i].count &&
+	  (best == runs.size() ||
+	   key_less(&runs[i].keys[at[i] * s.words],
+		    &runs[best].keys[at[best] * s.words], s.words)))
+	best = i;
+    return &runs[best].keys[at[best]++ * s.words];
+  });
+  for (const memo_run &r : runs)
+    munmap((void *) r.keys, r.count * s.words * sizeof(bigint));
+  t.disk -= disk;
+  t.read += disk;
+}
+
+// whether the quota leaves room for n more tuples on disk
+inline bool spill_room (const tuple_set &s, bigint n) {
+  const spill_tier &t = s.spill;
+  return !t.dir.empty() &&
+    (t.quota == 0 || t.disk + n * s.words * sizeof(bigint) <= t.quota);
+}
+
+// writes the records of recs, packed tuples followed by one word, to a
+// new run
+inline void spill (tuple_set &s, vector<bigint> &recs) {
+  const bigint stride = s.words+1, n = recs.size() / stride;
+  if (n == 0)
+    return;
+  vector<bigint> tmp;
+  radix_sort(recs, tmp, s.words);
+  bigint j = 0;
+  add_run(s, n, [&]() { return &recs[j++ * stride]; });
+  if (s.spill.runs.size() > MAX_RUNS)
+    merge_runs(s);
+}
+
+// whether run r holds key of hash h, reading the page it would be on
+inline bool in_run (tuple_set &s, const memo_run &r, const bigint *key,
+		    bigint h) {
+  if (!bloom_test(r.bloom, h))
+    return false;
+  const bigint w = s.words, page = page_tuples(s);
+  bigint lo = 0, hi = r.fences.size() / w;
+  while (lo < hi) {
+    bigint mid = (lo + hi) / 2;
+    if (key_less(key, &r.fences[mid * w], w))
+      hi = mid;
+    else
+      lo = mid+1;
+  }
+  if (lo == 0)
+    return false;
+  s.spill.read += PAGE_BYTES;
+  lo = (lo-1) * page;
+  hi = min(r.count, lo + page);
+  while (lo < hi) {
+    bigint mid = (lo + hi) / 2;
+    if (key_less(&r.keys[mid * w], key, w))
+      lo = mid+1;
+    else
+      hi = mid;
+  }
+  return lo < r.count && equal(key, key + w, &r.keys[lo * w]);
+}
+
+// whether some run of s holds key, the newest first
+inline bool in_runs (tuple_set &s, const bigint *key) {
+  spill_tier &t = s.spill;
+  if (t.runs.empty())
+    return false;
+  bigint h = hash_key(key, s.words), read = t.read;
+  for (bigint i = t.runs.size(); i-- > 0; )
+    if (in_run(s, t.runs[i], key, h)) {
+      t.hits++;
+      return true;
+    }
+  t.misses++;
+  t.filtered += t.read == read;
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Approximate memo
+//
+// A search for one solution may keep its memo in blocked Bloom filters
+// instead, at a few bits per tuple.  A false positive drops a tuple that
+// was never searched, so that a solution may be missed, but never one
+// that is reported; a search that finds none has to be run again with
+// the exact memo.  As the number of tuples is not known in advance, the
+// filters form a chain: once the last one holds as many tuples as it was
+// made for, a new one twice as large is added, with one more bit per
+// tuple, which lowers its rate of false positives by e^{(ln 2)^2}.  The
+// rate of the whole chain thus stays within that of the first filter
+// over 1 - e^{-(ln 2)^2}.
+
+const bigint BLOOM_FIRST = 1 << 10;	// tuples of the first filter
+
+// bits per tuple of the first filter for a rate of the whole chain
+inline double bloom_bits (double rate) {
+  const double ln2 = log(2);
+  return max(1.0, -log(rate * (1 - exp(-ln2 * ln2))) / (ln2 * ln2));
+}
+
+// bits per tuple, 0 for an exact memo
+inline void init_approx (tuple_set &s, double bits) {
+  s.approx = bits;
+  s.blooms.clear();
+  s.capacity = 0;
+}
+
+inline bool bloom_contains (const tuple_set &s, const bigint *key) {
+  bigint h = hash_key(key, s.words);
+  for (const bloom_filter &b : s.blooms)
+    if (bloom_test(b, h))
+      return true;
+  return false;
+}
+
+// adds key to the last filter, false if some filter may hold it
+inline bool bloom_insert (tuple_set &s, const bigint *key) {
+  if (bloom_contains(s, key))
+    return false;
+  if (s.count == s.capacity) {
+    bigint n = BLOOM_FIRST << s.blooms.size();
+    s.blooms.emplace_back();
+    init_bloom(s.blooms.back(), n, s.approx + s.blooms.size() - 1);
+    s.capacity += n;
+  }
+  bloom_add(s.blooms.back(), hash_key(key, s.words));
+  s.count++;
+  return true;
+}
+
+// estimated rate of false positives of the chain: a tuple passes a
+// filter whose blocks have a share f of their bits set with probability
+// f^probes
+inline double bloom_rate (const tuple_set &s) {
+  double pass = 1;
+  for (const bloom_filter &b : s.blooms) {
+    bigint set = 0;
+    for (bigint w : b.bits)
+      set += __builtin_popcountl(w);
+    pass *= 1 - pow(double(set) / (64 * b.bits.size()), b.probes);
+  }
+  return 1 - pass;
+}
+
+inline bigint bloom_bytes (const tuple_set &s) {
+  bigint n = 0;
+  for (const bloom_filter &b : s.blooms)
+    n += sizeof(b) + sizeof(bigint) * b.bits.capacity();
+  return n;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Bounded memo
+//
+// With a limit the memo holds at most that many tuples.  A tuple t is
+// asked for by the nodes at its parents t - e_i, so it counts in hits
+// the nodes that asked and is retired once there were as many as its
+// canonical parents; a tuple with a single parent is not kept at all.
+// A child is also above its parent in every coordinate and one level
+// above it, the level being x_1 + ... + x_{k-1}, saturated for
+// coordinates wider than a word, so a search only asks for a tuple
+// above one of the queued nodes, or above the level of the nodes the
+// threads hold, the floor.  A full set first drops the tuples behind
+// the frontier, those that neither hold.  If more than half the limit
+// is still taken, it evicts those of the highest levels down to half
+// of it, whose searches are the shortest, or spills those of the lowest
+// levels to disk, see spill().  It never evicts the tuples up to the
+// floor, which the threads are working on: a budget too small for them
+// fails with the size they need.  Nodes with the same x_1, ...,
+// x_{k-1} may ask for a retired or evicted tuple once more, which only
+// costs a search again: gyt may come to another solution first, but
+// gyt-all finds the same ones.
+
+template <typename N>
+inline bigint level (const N *val, bigint k) {
+  bigint l = 0;
+  for (bigint i = 0; i+1 < k; ++i)
+    l = bit_length(val[i]) > 64 ? OVER : add_sat(l, word(val[i], 0));
+  return l;
+}
+
+// x_1..x_{k-1} of a packed tuple, OVER for coordinates wider than a word
+inline void key_coords (const tuple_set &s, const bigint *key, bigint *x) {
+  for (bigint i = 0; i+1 < s.word.size(); ++i) {
+    if (s.span[i] > 1) {
+      x[i] = OVER;
+      continue;
+    }
+    x[i] = key[s.word[i]] >> s.shift[i];
+    if (s.bits[i] < 64)
+      x[i] &= (1UL << s.bits[i]) - 1;
+  }
+}
+
+// adds x_1..x_{k-1} of val to the minimal tuples in mins, k-1 words
+// apiece, unless one of them is below it
+template <typename N>
+void add_min (vector<bigint> &mins, const N *val, bigint k) {
+  const bigint n = mins.size();
+  for (bigint i = 0; i+1 < k; ++i)
+    mins.push_back(bit_length(val[i]) > 64 ? OVER : word(val[i], 0));
+  bigint m = 0;
+  for (bigint j = 0; j < n; j += k-1) {
+    bool below = true, above = true;
+    for (bigint i = 0; i+1 < k; ++i) {
+      below = below && mins[j+i] <= mins[n+i];
+      above = above && mins[j+i] >= mins[n+i];
+    }
+    if (below) {
+      mins.resize(n);
+      return;
+    }
+    if (!above) {
+      copy(&mins[j], &mins[j+k-1], &mins[m]);
+      m += k-1;
+    }
+  }
+  copy(&mins[n], &mins[n+k-1], &mins[m]);
+  mins.resize(m+k-1);
+}
+
+// whether some tuple of mins is below x
+inline bool above_min (const vector<bigint> &mins, const bigint *x,
+		       bigint d) {
+  for (bigint j = 0; j < mins.size(); j += d) {
+    bigint i = 0;
+    while (i < d && mins[j+i] <= x[i])
+      ++i;
+    if (i == d)
+      return true;
+  }
+  return false;
+}
+
+// parents of val that are canonical, given the classes by s.prev
+template <typename N>
+inline bigint parents (const tuple_set &s, const N *val) {
+  bigint k = s.prev.size(), n = 0;
+  for (bigint i = 0; i+1 < k; ++i)
+    n += val[i] > 0 && (s.prev[i] == k || val[i] > val[s.prev[i]]);
+  return n;
+}
+
+// empties slot h, moving back the tuples probed past it
+inline void erase (tuple_set &s, bigint h) {
+  for (bigint j = (h+1) & s.mask; s.slots[j * s.words] != 0;
+       j = (j+1) & s.mask) {
+    bigint home = table_hash(s, &s.slots[j * s.words]) & s.mask;
+    if (((j - home) & s.mask) >= ((j - h) & s.mask)) {
+      copy(&s.slots[j * s.words], &s.slots[(j+1) * s.words],
+	   &s.slots[h * s.words]);
+      s.hits[h] = s.hits[j];
+      h = j;
+    }
+  }
+  fill(&s.slots[h * s.words], &s.slots[(h+1) * s.words], 0);
+  s.count--;
+}
+
+// one more node asked for the tuple in slot h
+inline void ask (tuple_set &s, bigint h, bigint parents) {
+  if (++s.hits[h] < parents)
+    return;
+  erase(s, h);
+  s.retired++;
+}
+
+// a budget that cannot keep the n tuples up to the floor would evict
+// the children of the nodes the threads are at, and search them again
+// and again
+inline void budget_failed (const tuple_set &s, bigint n) {
+  bigint slots = 16;
+  while (slots < 4 * n)
+    slots *= 2;
+  const bigint mb = 1UL << 20,
+    bytes = slots * (s.words * sizeof(bigint) + 1) * s.shards;
+  cerr << "*** the memo budget is below the working set of the search, "
+       << "-M " << (bytes + mb - 1) / mb << " or more is needed" << endl;
+  exit(1);
+}
+
+inline void squeeze (tuple_set &s) {
+  const bigint d = s.word.size() - 1;
+  vector<bigint> mins, keys, levels, x(d);
+  vector<unsigned char> hits;
+  bigint floor = s.floor ? s.floor(mins) : 0;
+  keys.reserve(s.count * s.words);
+  levels.reserve(s.count);
+  hits.reserve(s.count);
+  for (bigint i = 0; i < s.slots.size(); i += s.words)
+    if (s.slots[i] != 0) {
+      key_coords(s, &s.slots[i], x.data());
+      bigint l = 0;
+      for (bigint v : x)
+	l = add_sat(l, v);
+      if (l < floor && !above_min(mins, x.data(), d)) {
+	s.retired++;
+	continue;
+      }
+      keys.insert(keys.end(), &s.slots[i], &s.slots[i] + s.words);
+      levels.push_back(l);
+      hits.push_back(s.hits[i / s.words]);
+    }
+  bigint n = levels.size(), keep = s.limit / 2, cut = 0, ties = 0;
+  bool spilling = n > keep && spill_room(s, n - keep);
+  if (n > keep && !spilling) {
+    bigint held = count_if(levels.begin(), levels.end(),
+			   [floor](bigint l) { return l <= floor; });
+    if (held > keep)
+      budget_failed(s, held);
+  }
+  if (spilling)
+    for (bigint &l : levels)
+      l = OVER - l;
+  if (n > keep) {
+    vector<bigint> order = levels;
+    nth_element(order.begin(), order.begin() + (keep - 1), order.end());
+    cut = order[keep - 1];
+    ties = keep - count_if(levels.begin(), levels.end(),
+			   [cut](bigint l) { return l < cut; });
+  }
+  vector<bigint> recs;
+  fill(s.slots.begin(), s.slots.end(), 0);
+  s.count = 0;
+  for (bigint j = 0; j < n; ++j) {
+    if (n > keep && levels[j] >= cut) {
+      if (levels[j] > cut || ties == 0) {
+	if (spilling) {
+	  recs.insert(recs.end(), &keys[j * s.words], &keys[(j+1) * s.words]);
+	  recs.push_back(0);
+	} else
+	  s.evicted++;
+	continue;
+      }
+      ties--;
+    }
+    bigint h = probe(s, &keys[j * s.words]);
+    copy(&keys[j * s.words], &keys[(j+1) * s.words], &s.slots[h * s.words]);
+    s.hits[h] = hits[j];
+    s.count++;
+  }
+  spill(s, recs);
+}
+
+inline bool insert_key (tuple_set &s, const bigint *key) {
+  if (2 * (s.count+1) > s.mask+1)
+    grow(s);
+  bigint h = probe(s, key);
+  if (s.slots[h * s.words] != 0) {
+    if (covers(s, &s.slots[h * s.words], key))
+      return false;
+    copy(key, key + s.words, &s.slots[h * s.words]);
+    return true;
+  }
+  copy(key, key + s.words, &s.slots[h * s.words]);
+  s.count++;
+  if (s.limit == 0)
+    return true;
+  s.hits[h] = 1;
+  s.peak = max(s.peak, s.count);
+  if (s.count >= s.limit)
+    squeeze(s);
+  return true;
+}
+
+template <typename N>
+bool contains (tuple_set &s, const N *val) {
+  pack(s, val);
+  if (s.approx != 0)
+    return bloom_contains(s, s.key.data());
+  bigint h = probe(s, s.key.data());
+  if (s.slots[h * s.words] == 0
+      || !covers(s, &s.slots[h * s.words], s.key.data()))
+    return in_runs(s, s.key.data());
+  if (s.limit != 0)
+    ask(s, h, parents(s, val));
+  return true;
+}
+
+// whether the column of val was entered before, at any x_k
+template <typename N>
+bool has_column (tuple_set &s, const N *val) {
+  if (s.column.empty() || s.approx != 0)
+    return false;
+  pack(s, val);
+  return s.slots[probe(s, s.key.data()) * s.words] != 0;
+}
+
+template <typename N>
+bool insert (tuple_set &s, const N *val) {
+  pack(s, val);
+  if (s.approx != 0)
+    return bloom_insert(s, s.key.data());
+  if (s.limit == 0)
+    return insert_key(s, s.key.data());
+  bigint n = parents(s, val), h = probe(s, s.key.data());
+  if (s.slots[h * s.words] != 0
+      && covers(s, &s.slots[h * s.words], s.key.data())) {
+    ask(s, h, n);
+    return false;
+  }
+  if (in_runs(s, s.key.data()))
+    return false;
+  if (n > 1)
+    return insert_key(s, s.key.data());
+  s.retired++;
+  return true;
+}
+
+// memory of the filters and fences of the runs
+inline bigint spill_bytes (const tuple_set &s) {
+  bigint n = 0;
+  for (const memo_run &r : s.spill.runs)
+    n += sizeof(r) + sizeof(bigint) *
+      (r.bloom.bits.capacity() + r.fences.capacity());
+  return n;
+}
+
+inline bigint set_bytes (const tuple_set &s) {
+  return sizeof(s) + s.hits.capacity() + sizeof(bigint) *
+    (s.slots.capacity() + s.key.capacity() + s.word.capacity() +
+     s.shift.capacity() + s.span.capacity() + s.bits.capacity() +
+     s.prev.capacity()) + spill_bytes(s) + bloom_bytes(s);
+}
+
+// at most bytes of slots and hits, for the classes of p, see
+// symmetries(); a full set is squeezed against floor()
+template <typename N>
+void init_budget (tuple_set &s, bigint bytes, const polynomial<N> &p,
+		  const function<bigint (vector<bigint> &)> &floor) {
+  bigint slots = 16;
+  while (2 * slots * (s.words * sizeof(bigint) + 1) <= bytes)
+    slots *= 2;
+  s.limit = slots / 2;
+  s.prev = p.prev;
+  s.hits.assign(s.mask+1, 0);
+  s.floor = floor;
+}
+
+// a bounded memo spills to dir, at most quota bytes, 0 for no bound
+inline void init_spill (tuple_set &s, const string &dir, bigint quota) {
+  if (access(dir.c_str(), W_OK) != 0)
+    spill_failed(dir);
+  s.spill.dir = dir;
+  s.spill.quota = quota;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Frontier
+//
+// The buffer only grows, so once it has reached the size of the largest
+// frontier no push or pop allocates.
+
+template <typename N>
+void init_arena (tuple_arena<N> &a, bigint stride) {
+  a.stride = stride;
+  a.count = 0;
+  a.data.clear();
+  a.free.clear();
+}
+
+template <typename N>
+void push (tuple_arena<N> &a, const N *val) {
+  if ((a.count+1) * a.stride > a.data.size())
+    a.data.resize(max(bigint(2 * a.data.size()), 16 * a.stride));
+  copy(val, val + a.stride, &a.data[a.count * a.stride]);
+  a.count++;
+}
+
+template <typename N>
+const N *top (const tuple_arena<N> &a) {
+  return &a.data[(a.count-1) * a.stride];
+}
+
+template <typename N>
+void pop (tuple_arena<N> &a) {
+  a.count--;
+}
+
+template <typename N>
+bigint alloc (tuple_arena<N> &a, const N *val) {
+  bigint s;
+  if (!a.free.empty()) {
+    s = a.free.back();
+    a.free.pop_back();
+  } else {
+    s = a.data.size() / a.stride;
+    a.data.resize(a.data.size() + a.stride);
+    a.free.reserve(s+1);
+  }
+  copy(val, val + a.stride, &a.data[s * a.stride]);
+  a.count++;
+  return s;
+}
+
+template <typename N>
+const N *slot (const tuple_arena<N> &a, bigint s) {
+  return &a.data[s * a.stride];
+}
+
+template <typename N>
+void release (tuple_arena<N> &a, bigint s) {
+  a.free.push_back(s);
+  a.count--;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Sharing between threads
+//
+// Locks are only taken when a structure is really shared, so that a
+// single thread runs at the speed of the plain structures.
+
+template <typename N>
+void init_shared (shared_set &s, const val_tuple<N> &bound, bool shared) {
+  s.shared = shared;
+  for (tuple_set &t : s.shard)
+    init_set(t, bound);
+}
+
+inline void init_columns (shared_set &s) {
+  for (tuple_set &t : s.shard)
+    init_columns(t);
+}
+
+template <typename N>
+bigint shard (const shared_set &s, const N *val) {
+  bigint h = 0, k = s.shard[0].word.size() - !s.shard[0].column.empty();
+  for (bigint i = 0; i < k; ++i)
+    h = (h ^ word(val[i], 0)) * 0x9e3779b97f4a7c15UL;
+  return (h >> 32) % s.shard.size();
+}
+
+template <typename N>
+bool contains (shared_set &s, const N *val) {
+  bigint n = shard(s, val);
+  unique_lock<mutex> guard(s.locks[n], defer_lock);
+  if (s.shared)
+    guard.lock();
+  return contains(s.shard[n], val);
+}
+
+template <typename N>
+bool has_column (shared_set &s, const N *val) {
+  bigint n = shard(s, val);
+  unique_lock<mutex> guard(s.locks[n], defer_lock);
+  if (s.shared)
+    guard.lock();
+  return has_column(s.shard[n], val);
+}
+
+template <typename N>
+bool insert (shared_set &s, const N *val) {
+  bigint n = shard(s, val);
+  unique_lock<mutex> guard(s.locks[n], defer_lock);
+  if (s.shared)
+    guard.lock();
+  return insert(s.shard[n], val);
+}
+
+// A column entered again above its entry in the memo is galloped down
+// to its end first: the walk from any x_k above the end pushes the same
+// children, so it is searched again only if the end is above the entry.
+// True if it is not; val is left at the end.
+template <typename N, typename S>
+bool column_done (const polynomial<N> &p, eval_state<N> &es, const N &B,
+		  S &s, val_tuple<N> &val) {
+  if (!has_column(s, val.data()))
+    return false;
+  N x = val[p.k-1], result = eval(p, es, val);
+  if (result > B &&
+      !gallop(p, es, val, p.k-1, column_floor(p, val), B, result)) {
+    val[p.k-1] = x;
+    return false;
+  }
+  return contains(s, val.data());
+}
+
+inline bigint set_count (const shared_set &s) {
+  bigint n = 0;
+  for (const tuple_set &t : s.shard)
+    n += t.count;
+  return n;
+}
+
+inline bigint set_bytes (const shared_set &s) {
+  bigint n = 0;
+  for (const tuple_set &t : s.shard)
+    n += set_bytes(t);
+  return n;
+}
+
+// the budget is split evenly between the shards
+template <typename N>
+void init_budget (shared_set &s, bigint bytes, const polynomial<N> &p,
+		  const function<bigint (vector<bigint> &)> &floor) {
+  for (tuple_set &t : s.shard) {
+    init_budget(t, bytes / s.shard.size(), p, floor);
+    t.shards = s.shard.size();
+  }
+}
+
+// and so is the quota
+inline void init_spill (shared_set &s, const string &dir, bigint quota) {
+  for (tuple_set &t : s.shard)
+    init_spill(t, dir, quota / s.shard.size());
+}
+
+inline void init_approx (shared_set &s, double bits) {
+  for (tuple_set &t : s.shard)
+    init_approx(t, bits);
+}
+
+// a tuple is looked up in one shard, the larger ones more often
+inline double bloom_rate (const shared_set &s) {
+  bigint n = 0;
+  double rate = 0;
+  for (const tuple_set &t : s.shard) {
+    n += t.count;
+    rate += t.count * bloom_rate(t);
+  }
+  return n == 0 ? 0 : rate / n;
+}
+
+template <typename N>
+void init_deque (work_deque<N> &d, bigint stride, bool shared) {
+  d.shared = shared;
+  d.head = 0;
+  init_arena(d.a, stride);
+}
+
+template <typename N>
+void push (work_deque<N> &d, const N *val) {
+  unique_lock<mutex> guard(d.lock, defer_lock);
+  if (d.shared)
+    guard.lock();
+  if (d.head > 0 && (d.a.count+1) * d.a.stride > d.a.data.size()) {
+    copy(&d.a.data[d.head * d.a.stride], &d.a.data[d.a.count * d.a.stride],
+	 d.a.data.begin());
+    d.a.count -= d.head;
+    d.head = 0;
+  }
+  push(d.a, val);
+}
+
+template <typename N>
+bool pop (work_deque<N> &d, N *val) {
+  unique_lock<mutex> guard(d.lock, defer_lock);
+  if (d.shared)
+    guard.lock();
+  if (d.a.count == d.head)
+    return false;
+  copy(top(d.a), top(d.a) + d.a.stride, val);
+  pop(d.a);
+  if (d.a.count == d.head)
+    d.a.count = d.head = 0;
+  return true;
+}
+
+template <typename N>
+bool steal (work_deque<N> &d, N *val) {
+  lock_guard<mutex> guard(d.lock);
+  if (d.a.count == d.head)
+    return false;
+  const N *t = &d.a.data[d.head * d.a.stride];
+  copy(t, t + d.a.stride, val);
+  d.head++;
+  if (d.a.count == d.head)
+    d.a.count = d.head = 0;
+  return true;
+}
+
+template <typename N>
+bigint deque_size (work_deque<N> &d) {
+  unique_lock<mutex> guard(d.lock, defer_lock);
+  if (d.shared)
+    guard.lock();
+  return d.a.count - d.head;
+}
+
+// adds the tuples of the deque to mins, see add_min()
+template <typename N>
+void deque_mins (work_deque<N> &d, bigint k, vector<bigint> &mins) {
+  unique_lock<mutex> guard(d.lock, defer_lock);
+  if (d.shared)
+    guard.lock();
+  for (bigint i = d.head; i < d.a.count; ++i)
+    add_min(mins, &d.a.data[i * d.a.stride], k);
+}
+
+// the minimal tuples of the deques, and the floor of the levels of the
+// nodes taken by the threads, 0 while a thread takes one; the deques are
+// read first, so that a node on its way to a thread is seen in one or
+// the other
+template <typename N>
+bigint frontier_floor (vector<work_deque<N>> &deques,
+		       const vector<atomic<bigint>> &hands, bigint k,
+		       vector<bigint> &mins) {
+  for (work_deque<N> &d : deques)
+    deque_mins(d, k, mins);
+  bigint low = OVER;
+  for (const atomic<bigint> &h : hands)
+    low = min(low, h.load(memory_order_relaxed));
+  return add_sat(low, 1UL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Checkpoints
+//
+// A checkpoint holds the state of a search between two nodes.  Counters
+// and packed tuples are written in their native layout, for the same
+// build to read back; numbers are written as their words, so that the
+// twins read each other's checkpoints.  While the search threads are
+// joined and the heartbeat is held at its lock, so that no other thread
+// is inside the streams or the allocator, a child process is forked to
+// write the state, and the search goes on at once on pages shared with
+// the child until it writes to them.  The new file replaces the old one
+// only once complete.  SIGUSR2 asks for a checkpoint, SIGTERM and SIGINT
+// for a last one before stopping.
+
+const bigint CHECKPOINT_MAGIC = 0x31706b6374796721UL;
+
+inline volatile sig_atomic_t checkpoint_requests = 0;
+inline volatile sig_atomic_t checkpoint_stop = 0;
+inline pid_t checkpoint_writer = 0;	// child writing the last checkpoint
+
+inline pid_t quiet_fork ();
+
+template <typename T>
+inline void put_raw (ostream &out, const T &x) {
+  out.write((const char *) &x, sizeof x);
+}
+
+template <typename T>
+inline void get_raw (istream &in, T &x) {
+  in.read((char *) &x, sizeof x);
+}
+
+template <typename N>
+void put_number (ostream &out, const N &x) {
+  bigint n = (bit_length(x) + 63) / 64;
+  put_raw(out, n);
+  for (bigint j = 0; j < n; ++j)
+    put_raw(out, word(x, j));
+}
+
+template <typename N>
+void get_number (istream &in, N &x) {
+  bigint n = 0;
+  get_raw(in, n);
+  if (n == 0 || n > 1 << 20) {
+    in.setstate(ios::failbit);
+    return;
+  }
+  vector<bigint> w(n);
+  in.read((char *) w.data(), n * sizeof(bigint));
+  if (!from_words(x, w.data(), n))
+    in.setstate(ios::failbit);
+}
+
+template <typename N>
+void put_tuple (ostream &out, const val_tuple<N> &val) {
+  put_raw(out, bigint(val.size()));
+  for (const N &x : val)
+    put_number(out, x);
+}
+
+template <typename N>
+void get_tuple (istream &in, val_tuple<N> &val) {
+  bigint n = 0;
+  get_raw(in, n);
+  val.assign(in ? min(n, bigint(1 << 20)) : 0, N(0));
+  for (N &x : val)
+    get_number(in, x);
+}
+
+// the packed tuples of the set, in slot order, gathered into blocks
+inline void put_set (ostream &out, const tuple_set &s) {
+  put_raw(out, s.count);
+  vector<bigint> block;
+  block.reserve(1 << 16);
+  for (bigint i = 0; i < s.slots.size(); i += s.words) {
+    if (s.slots[i] != 0)
+      block.insert(block.end(), &s.slots[i], &s.slots[i] + s.words);
+    if (block.size() + s.words > block.capacity() ||
+	i + s.words == s.slots.size()) {
+      out.write((const char *) block.data(), block.size() * sizeof(bigint));
+      block.clear();
+    }
+  }
+}
+
+// adds the tuples written by put_set() to s, laid out for the same bounds
+inline void get_set (istream &in, tuple_set &s) {
+  bigint n = 0;
+  get_raw(in, n);
+  vector<bigint> key(s.words);
+  for (bigint i = 0; i < n && in; ++i) {
+    in.read((char *) key.data(), s.words * sizeof(bigint));
+    insert_key(s, key.data());
+  }
+}
+
+// the tuples of the deque, oldest first
+template <typename N>
+void put_deque (ostream &out, const work_deque<N> &d) {
+  put_raw(out, d.a.count - d.head);
+  for (bigint i = d.head * d.a.stride; i < d.a.count * d.a.stride; ++i)
+    put_number(out, d.a.data[i]);
+}
+
+// pushes the tuples written by put_deque() onto d
+template <typename N>
+void get_deque (istream &in, work_deque<N> &d) {
+  bigint n = 0;
+  get_raw(in, n);
+  val_tuple<N> node(d.a.stride);
+  for (bigint i = 0; i < n && in; ++i) {
+    for (N &x : node)
+      get_number(in, x);
+    push(d, node.data());
+  }
+}
+
+inline void request_checkpoint (int sig) {
+  checkpoint_requests = 1;
+  if (sig != SIGUSR2)
+    checkpoint_stop = 1;
+}
+
+inline void watch_checkpoints () {
+  signal(SIGUSR2, request_checkpoint);
+  signal(SIGTERM, request_checkpoint);
+  signal(SIGINT, request_checkpoint);
+}
+
+// waits until the search is over, false, or a checkpoint is due, true;
+// one asked for before is due at once
+inline bool checkpoint_due (const atomic<bigint> &pending, double interval) {
+  auto start = chrono::steady_clock::now();
+  while (pending > 0) {
+    if (checkpoint_requests) {
+      checkpoint_requests = 0;
+      return true;
+    }
+    this_thread::sleep_for(chrono::milliseconds(10));
+    double now = chrono::duration<double>
+      (chrono::steady_clock::now() - start).count();
+    if (now >= interval)
+      return true;
+  }
+  return false;
+}
+
+inline void wait_checkpoint () {
+  if (checkpoint_writer > 0)
+    waitpid(checkpoint_writer, nullptr, 0);
+  checkpoint_writer = 0;
+}
+
+// writes the checkpoint through save(out), in a child process unless
+// the search stops
+template <typename Save>
+void write_checkpoint (const string &file, bool stop, const Save &save) {
+  wait_checkpoint();
+  pid_t pid = stop ? -1 : quiet_fork();
+  if (pid > 0) {
+    checkpoint_writer = pid;
+    return;
+  }
+  string tmp = file + ".tmp";
+  ofstream out(tmp, ios::binary);
+  put_raw(out, CHECKPOINT_MAGIC);
+  save(out);
+  put_raw(out, CHECKPOINT_MAGIC);
+  out.close();
+  bool ok = out && rename(tmp.c_str(), file.c_str()) == 0;
+  if (!ok)
+    cerr << "*** cannot write checkpoint " << file << endl;
+  if (pid == 0)
+    _exit(!ok);
+}
+
+inline void bad_checkpoint (const string &file, const string &why) {
+  cerr << "*** checkpoint " << file << " " << why << endl;
+  exit(1);
+}
+
+// reads the checkpoint through load(in)
+template <typename Load>
+void read_checkpoint (const string &file, const Load &load) {
+  ifstream in(file, ios::binary);
+  bigint magic = 0;
+  get_raw(in, magic);
+  if (!in || magic != CHECKPOINT_MAGIC)
+    bad_checkpoint(file, "cannot be read");
+  load(in);
+  magic = 0;
+  get_raw(in, magic);
+  if (!in || magic != CHECKPOINT_MAGIC)
+    bad_checkpoint(file, "is truncated");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Progress
+//
+// Every search thread publishes its counters, its frontier size and x_1
+// into a slot of its own with relaxed stores, once per node.  With -H
+// seconds, a monitor thread samples the slots and prints a heartbeat
+// to stderr, so that the search itself never waits.  SIGUSR1 only
+// bumps a counter; every search thread notices it at its next node and
+// dumps its counters and the node it took from its frontier.
+
+struct progress_slot {
+  atomic<bigint> evals{0};	// evaluations and deltas
+  atomic<bigint> frontier{0};
+  atomic<bigint> memo{0};	// memo entries added by the thread
+  atomic<bigint> x1{0};		// lowest word of x_1
+};
+
+struct progress_monitor {
+  vector<progress_slot> slots;
+  double interval = 0;		// seconds between heartbeats, 0 for none
+  atomic<bool> done{false};
+  thread sampler;
+  mutex out;
+};
+
+inline progress_monitor progress;
+inline volatile sig_atomic_t dump_requests = 0;
+inline thread_local sig_atomic_t dumps_seen = 0;
+
+inline void request_dump (int) {
+  dump_requests = dump_requests + 1;
+}
+
+inline void heartbeat () {
+  auto start = chrono::steady_clock::now();
+  double last = 0;
+  bigint last_evals = 0;
+  while (!progress.done) {
+    this_thread::sleep_for(chrono::milliseconds(50));
+    double now = chrono::duration<double>
+      (chrono::steady_clock::now() - start).count();
+    if (now - last < progress.interval)
+      continue;
+    bigint evals = 0, frontier = 0, memo = 0, x1 = ULONG_MAX;
+    for (const progress_slot &s : progress.slots) {
+      bigint e = s.evals.load(memory_order_relaxed);
+      evals += e;
+      frontier += s.frontier.load(memory_order_relaxed);
+      memo += s.memo.load(memory_order_relaxed);
+      if (e > 0)
+	x1 = min(x1, s.x1.load(memory_order_relaxed));
+    }
+    lock_guard<mutex> guard(progress.out);
+    cerr << "+++ " << (bigint) now << " s: "
+	 << (bigint) ((evals - last_evals) / (now - last)) << " evals/s, "
+	 << "frontier " << frontier << ", memo " << memo;
+    if (x1 != ULONG_MAX)
+      cerr << ", x_1 = " << x1;
+    cerr << endl;
+    last = now;
+    last_evals = evals;
+  }
+}
+
+inline void start_progress (bigint threads, double interval) {
+  progress.slots = vector<progress_slot>(threads);
+  progress.interval = interval;
+  progress.done = false;
+  signal(SIGUSR1, request_dump);
+  if (interval > 0)
+    progress.sampler = thread(heartbeat);
+}
+
+inline void stop_progress () {
+  progress.done = true;
+  if (progress.sampler.joinable())
+    progress.sampler.join();
+}
+
+// forks while the heartbeat waits for its lock, see write_checkpoint()
+inline pid_t quiet_fork () {
+  lock_guard<mutex> guard(progress.out);
+  return fork();
+}
+
+template <typename N>
+inline void publish (bigint id, const val_tuple<N> &val, bigint frontier,
+		     bigint memo) {
+  progress_slot &s = progress.slots[id];
+  s.evals.store(num_of_evals + num_of_deltas, memory_order_relaxed);
+  s.frontier.store(frontier, memory_order_relaxed);
+  s.memo.store(memo, memory_order_relaxed);
+  s.x1.store(word(val[0], 0), memory_order_relaxed);
+  if (dumps_seen == dump_requests)
+    return;
+  dumps_seen = dump_requests;
+  lock_guard<mutex> guard(progress.out);
+  cerr << "*** thread " << id << ": evals = " << num_of_evals
+       << ", deltas = " << num_of_deltas << ", steps saved = "
+       << num_of_saved << ", children cut = " << num_of_cuts
+       << ", frontier = " << frontier << ", memo = " << memo << endl;
+  cerr << "    top =";
+  for (const N &x : val)
+    cerr << " " << x;
+  cerr << endl;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Levels
+//
+// Instead of a stack and a memo, the tableau can be walked level by
+// level, the level of a tuple being x_1 + ... + x_{k-1}.  Every node of
+// a level walks its column as in the depth-first search and appends its
+// children to the next level; only these two levels are kept.  The
+// threads expand slices of the level into buffers of their own, then
+// the children are radix sorted by x_1..x_{k-1}, packed as in the memo,
+// and those of the same x_1..x_{k-1} are merged into one, with the
+// highest x_k and the lowest limits among them: the walk of the column
+// from the highest x_k passes all the others, and the limits hold for
+// each of them.  So every column is walked once, and every canonical
+// solution is found once, without a memo or a set of solutions.
+
+// the counters of a search thread, see take_counters()
+struct level_counters {
+  bigint split = 0;
+  bigint evals = 0, deltas = 0, cuts = 0, boxes = 0, pruned = 0;
+  long long saved = 0;
+  long double volume = 0;
+  bigint columns = 0, filtered = 0;
+};
+
+template <typename N>
+struct level_search {
+  const polynomial<N> &p;
+  const N B;
+  const val_tuple<N> &bound;
+  const residue_filter &filter;
+  bool prune;			// drop nodes whose box cannot reach B
+  function<bool (const val_tuple<N> &)> found;	// false stops the search
+  mutex out;
+  atomic<bool> stop;
+  vector<N> level;		// nodes of the level, 2k-1 numbers each
+  vector<vector<N>> next;	// children of the level, by thread
+  vector<bigint> recs, tmp;	// packed x_1..x_{k-1} and node, to sort
+  vector<const N *> nodes;	// the children by their number in recs
+  tuple_set keys;
+  vector<level_counters> counters;	// by thread
+  vector<eval_state<N>> es;
+  bigint levels = 0;
+  bigint split = 0;
+  bigint width = 0;		// nodes of the widest level
+  bigint bytes = 0;		// peak bytes of both levels and the sort
+  bigint merged = 0;		// children merged into another
+  level_search (const polynomial<N> &p, const N &B,
+		const val_tuple<N> &bound, const residue_filter &filter,
+		bool prune, const function<bool (const val_tuple<N> &)> &found)
+    : p(p), B(B), bound(bound), filter(filter), prune(prune), found(found) {}
+};
+
+// swaps the counters of the calling thread with those in c, so that a
+// thread started for every level counts on where the last one stopped
+inline void take_counters (level_counters &c) {
+  swap(c.evals, num_of_evals);
+  swap(c.deltas, num_of_deltas);
+  swap(c.saved, num_of_saved);
+  swap(c.cuts, num_of_cuts);
+  swap(c.boxes, num_of_boxes);
+  swap(c.pruned, num_of_pruned);
+  swap(c.volume, pruned_volume);
+  swap(c.columns, num_of_columns);
+  swap(c.filtered, num_of_filtered);
+}
+
+template <typename N>
+void expand_slice (level_search<N> &s, bigint id, bigint from, bigint to) {
+  const polynomial<N> &p = s.p;
+  const bigint stride = 2*p.k-1, width = s.level.size() / stride;
+  eval_state<N> &es = s.es[id];
+  val_tuple<N> val(p.k), valx(p.k), lim(p.k-1), node(stride);
+  val_tuple<N> lo(p.k), hi(p.k);
+  vector<N> &next = s.next[id];
+  vector<bool> pushed(p.k-1);
+  for (bigint j = from; j < to && !s.stop; ++j) {
+    unpack_node(p, &s.level[j * stride], val, lim);
+    publish(id, val, width, 0);
+    if (s.prune && prune_node(p, s.B, val, lim, lo, hi))
+      continue;
+    fill(pushed.begin(), pushed.end(), false);
+    bigint put = 0;
+    while (test_bound(val, s.bound, p.k) && val[p.k-1] >= 0 &&
+	   canonical_column(p, val)) {
+      N result = eval(p, es, val);
+      if (result > s.B &&
+	  !skip_column(p, es, s.filter, s.B, val, result) &&
+	  !gallop(p, es, val, p.k-1, column_floor(p, val), s.B, result))
+	break;
+      bool solution = result == s.B;
+      if (solution) {
+	lock_guard<mutex> guard(s.out);
+	if (s.stop || !s.found(val)) {
+	  s.stop = true;
+	  break;
+	}
+      }
+      for (bigint i = 0; i < p.k-1; ++i) {
+	valx = val;
+	valx[i]++;
+	if (pushed[i] || !canonical_step(p, val, i) ||
+	    (solution ? !solution_step(p, es, s.B, valx, lim, i) :
+	     !child_fits(p, es, s.B, valx, lim, i)))
+	  continue;
+	pack_node(p, valx, lim, node.data());
+	next.insert(next.end(), node.begin(), node.end());
+	pushed[i] = true;
+	put++;
+      }
+      if (!solution)
+	break;
+      val[p.k-1]--;
+    }
+    s.counters[id].split += put > 1;
+  }
+}
+
+// the children of all threads, merged by x_1..x_{k-1}, become the level
+template <typename N>
+void merge_level (level_search<N> &s) {
+  const polynomial<N> &p = s.p;
+  const bigint stride = 2*p.k-1, words = s.keys.words;
+  vector<const N *> &nodes = s.nodes;
+  nodes.clear();
+  s.recs.clear();
+  for (const vector<N> &v : s.next)
+    for (bigint j = 0; j < v.size(); j += stride) {
+      pack(s.keys, &v[j]);
+      s.recs.insert(s.recs.end(), s.keys.key.begin(), s.keys.key.end());
+      s.recs.push_back(nodes.size());
+      nodes.push_back(&v[j]);
+    }
+  radix_sort(s.recs, s.tmp, words);
+
+  bigint n = nodes.size(), bytes = 0;
+  for (const vector<N> &v : s.next)
+    bytes += v.capacity() * sizeof(N);
+  s.level.clear();
+  for (bigint a = 0, b; a < n; a = b) {
+    const bigint *key = &s.recs[a * (words+1)];
+    const N *node = nodes[key[words]];
+    s.level.insert(s.level.end(), node, node + stride);
+    N *m = &s.level[s.level.size() - stride];
+    for (b = a+1; b < n; ++b) {
+      const bigint *other = &s.recs[b * (words+1)];
+      if (!equal(key, key + words, other))
+	break;
+      node = nodes[other[words]];
+      m[p.k-1] = max(m[p.k-1], node[p.k-1]);
+      for (bigint i = p.k; i < stride; ++i)
+	m[i] = min(m[i], node[i]);
+    }
+  }
+  bytes += s.level.capacity() * sizeof(N) + sizeof(bigint) *
+    (s.recs.capacity() + s.tmp.capacity() + nodes.capacity());
+  s.bytes = max(s.bytes, bytes);
+  s.merged += n - s.level.size() / stride;
+  for (vector<N> &v : s.next)
+    v.clear();
+}
+
+const bigint MIN_SLICE = 256;	// nodes per thread of a level
+
+// walks the tableau from the nodes in s.level with up to jobs threads,
+// one per MIN_SLICE nodes of a level, until a level is empty or found()
+// returns false; the counters of all threads are left to the calling one
+template <typename N>
+void search_levels (level_search<N> &s, bigint jobs) {
+  const bigint stride = 2*s.p.k-1;
+  s.next.assign(jobs, vector<N>());
+  s.counters.assign(jobs, level_counters());
+  s.es.assign(jobs, eval_state<N>());
+  init_set(s.keys, val_tuple<N>(s.bound.begin(), s.bound.end() - 1));
+  s.stop = false;
+  while (!s.level.empty() && !s.stop) {
+    bigint n = s.level.size() / stride;
+    bigint used = max(1UL, min(jobs, n / MIN_SLICE));
+    s.levels++;
+    s.width = max(s.width, n);
+    vector<thread> threads;
+    for (bigint t = 1; t < used; ++t)
+      threads.emplace_back([&s, t, n, used]() {
+	take_counters(s.counters[t]);
+	expand_slice(s, t, n * t / used, n * (t+1) / used);
+	take_counters(s.counters[t]);
+      });
+    expand_slice(s, 0, 0, n / used);
+    for (thread &t : threads)
+      t.join();
+    merge_level(s);
+  }
+  for (const level_counters &c : s.counters)
+    s.split += c.split;
+  for (bigint t = 1; t < jobs; ++t) {
+    const level_counters &c = s.counters[t];
+    num_of_evals += c.evals;
+    num_of_deltas += c.deltas;
+    num_of_saved += c.saved;
+    num_of_cuts += c.cuts;
+    num_of_boxes += c.boxes;
+    num_of_pruned += c.pruned;
+    pruned_volume += c.volume;
+    num_of_columns += c.columns;
+    num_of_filtered += c.filtered;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Statistics
+//
+// A run is cut into the phases read_input, get_bounds (with the power
+// tables and the filters), search and output, each timed in wall and
+// CPU time of all threads.  With -J file, the times and the counters
+// of statistics() are written to file as one JSON object, apart from
+// the solutions on stdout.  Every engine writes the same keys, zero
+// where they do not apply; counters of its own go to "extra".
+
+struct run_stats {
+  string file;			// JSON output, none if empty
+  string program;
+  vector<string> phases;
+  vector<double> wall, cpu;
+  chrono::steady_clock::time_point start;
+  double cpu_start;
+  bigint solutions = 0;
+  bigint memo = 0, memo_bytes = 0;
+  bigint frontier = 0, frontier_bytes = 0;
+  bigint splits = 0, backtracks = 0, doubles = 0;
+  vector<pair<string, long double>> extra;
+};
+
+inline run_stats stats;
+
+inline double cpu_seconds () {
+  timespec t;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+inline void json_stats (const char *file, const char *program) {
+  stats.file = file;
+  stats.program = program;
+  stats.program = stats.program.substr(stats.program.rfind('/') + 1);
+}
+
+// ends the running phase, if any, and starts name, if any
+inline void phase (const string &name) {
+  auto now = chrono::steady_clock::now();
+  double cpu = cpu_seconds();
+  if (!stats.phases.empty() && stats.wall.size() < stats.phases.size()) {
+    stats.wall.push_back(chrono::duration<double>(now - stats.start).count());
+    stats.cpu.push_back(cpu - stats.cpu_start);
+  }
+  if (name.empty())
+    return;
+  stats.phases.push_back(name);
+  stats.start = now;
+  stats.cpu_start = cpu;
+}
+
+inline void extra (const string &key, long double value) {
+  stats.extra.push_back({key, value});
+}
+
+// evals/s are taken over get_bounds and search
+inline void write_stats () {
+  phase("");
+  if (stats.file.empty())
+    return;
+  ofstream out(stats.file);
+  if (!out) {
+    cerr << "*** cannot write " << stats.file << endl;
+    return;
+  }
+  double busy = 0;
+  out.precision(12);
+  out << "{\"program\": \"" << stats.program << "\", \"phases\": {";
+  for (bigint i = 0; i < stats.phases.size(); ++i) {
+    out << (i > 0 ? ", " : "") << "\"" << stats.phases[i]
+	<< "\": {\"wall\": " << stats.wall[i]
+	<< ", \"cpu\": " << stats.cpu[i] << "}";
+    if (stats.phases[i] == "get_bounds" || stats.phases[i] == "search")
+      busy += stats.wall[i];
+  }
+  bigint evals = num_of_evals + num_of_deltas;
+  out << "}, \"solutions\": " << stats.solutions
+      << ", \"evals\": " << num_of_evals
+      << ", \"deltas\": " << num_of_deltas
+      << ", \"evals_per_s\": " << (busy > 0 ? (bigint) (evals / busy) : 0)
+      << ", \"splits\": " << stats.splits
+      << ", \"backtracks\": " << stats.backtracks
+      << ", \"doubles\": " << stats.doubles
+      << ", \"memo_size\": " << stats.memo
+      << ", \"peak_memo_bytes\": " << stats.memo_bytes
+      << ", \"max_frontier\": " << stats.frontier
+      << ", \"peak_frontier_bytes\": " << stats.frontier_bytes
+      << ", \"steps_saved\": " << num_of_saved
+      << ", \"children_cut\": " << num_of_cuts
+      << ", \"residue_columns\": " << num_of_columns
+      << ", \"residue_hits\": " << num_of_filtered
+      << ", \"extra\": {";
+  for (bigint i = 0; i < stats.extra.size(); ++i)
+    out << (i > 0 ? ", " : "") << "\"" << stats.extra[i].first << "\": "
+	<< stats.extra[i].second;
+  out << "}}" << endl;
+}
+
+inline void print_kmg (bigint n) {
+  cout << n;
+  const string kmg = " KMG";
+  bigint idx = 0;
+  while (n > 1024 && idx < 3) {
+    n /= 1024;
+    idx++;
+  }
+  if (idx > 0)
+    cout << " (" << n << kmg[idx] << ")";
+  cout << endl;
+}
+
+inline void statistics (bigint msize,
+			bigint mbytes,
+			const string what,
+			const bigint &maxstack,
+			const bigint &maxbytes,
+			const bigint &split,
+			const bigint &nback,
+			const bigint &dbl) {
+  stats.memo = msize;
+  stats.memo_bytes = mbytes;
+  stats.frontier = maxstack;
+  stats.frontier_bytes = maxbytes;
+  stats.splits = split;
+  stats.backtracks = nback;
+  stats.doubles = dbl;
+  cout << "*** memo size       = ";
+  print_kmg(msize);
+  cout << "    memo bytes      = ";
+  print_kmg(mbytes);
+  cout << "    max " << what << " size  = " << maxstack << endl;
+  cout << "    max " << what << " bytes = ";
+  print_kmg(maxbytes);
+  cout << "    # of splits     = " << split << endl;
+  cout << "    # of backtracks = " << nback << endl;
+  cout << "    doubles reached = " << dbl << endl;
+  cout << "    # of evals      = " << num_of_evals << endl;
+  cout << "    # of deltas     = " << num_of_deltas << endl;
+  cout << "    steps saved     = " << num_of_saved << endl;
+  cout << "    children cut    = " << num_of_cuts << endl;
+  if (num_of_boxes > 0) {
+    cout << "    boxes pruned    = " << num_of_pruned << " of "
+	 << num_of_boxes << " (" << 100 * num_of_pruned / num_of_boxes
+	 << "%)" << endl;
+    cout << "    pruned volume   = " << pruned_volume << endl;
+    extra("boxes", num_of_boxes);
+    extra("boxes_pruned", num_of_pruned);
+    extra("pruned_volume", pruned_volume);
+  }
+  if (num_of_columns > 0)
+    cout << "    residue hits    = " << num_of_filtered << " of "
+	 << num_of_columns << " (" << 100 * num_of_filtered / num_of_columns
+	 << "%)" << endl;
+}
+
+// a level search keeps no memo; its frontier is the widest level
+template <typename N>
+void level_statistics (const level_search<N> &s) {
+  statistics(0, 0, "level", s.width, s.bytes, s.split, 0, s.merged);
+  cout << "    # of levels     = " << s.levels << endl;
+  extra("levels", s.levels);
+}
+
+inline void budget_statistics (bigint peak, bigint retired, bigint evicted) {
+  cout << "    memo peak       = ";
+  print_kmg(peak);
+  cout << "    memo retired    = " << retired << endl;
+  cout << "    memo evicted    = " << evicted << endl;
+  extra("memo_peak", peak);
+  extra("memo_retired", retired);
+  extra("memo_evicted", evicted);
+}
+
+inline void budget_statistics (const tuple_set &s) {
+  budget_statistics(max(s.peak, s.count), s.retired, s.evicted);
+}
+
+// the peak of a shared memo adds up the peaks of its shards
+inline void budget_statistics (const shared_set &s) {
+  bigint peak = 0, retired = 0, evicted = 0;
+  for (const tuple_set &t : s.shard) {
+    peak += max(t.peak, t.count);
+    retired += t.retired;
+    evicted += t.evicted;
+  }
+  budget_statistics(peak, retired, evicted);
+}
+
+inline void spill_statistics (const vector<const tuple_set *> &sets) {
+  spill_tier sum;
+  bigint runs = 0, tuples = 0;
+  for (const tuple_set *s : sets) {
+    const spill_tier &t = s->spill;
+    runs += t.runs.size();
+    for (const memo_run &r : t.runs)
+      tuples += r.count;
+    sum.disk += t.disk;
+    sum.written += t.written;
+    sum.read += t.read;
+    sum.hits += t.hits;
+    sum.misses += t.misses;
+    sum.filtered += t.filtered;
+  }
+  cout << "    memo on disk    = " << tuples << " in " << runs
+       << " runs" << endl;
+  cout << "    disk bytes      = ";
+  print_kmg(sum.disk);
+  cout << "    disk hits       = " << sum.hits << endl;
+  cout << "    disk misses     = " << sum.misses << " ("
+       << sum.filtered << " filtered)" << endl;
+  cout << "    bytes written   = ";
+  print_kmg(sum.written);
+  cout << "    bytes read      = ";
+  print_kmg(sum.read);
+  extra("memo_disk", tuples);
+  extra("memo_runs", runs);
+  extra("disk_bytes", sum.disk);
+  extra("disk_hits", sum.hits);
+  extra("disk_misses", sum.misses);
+  extra("disk_filtered", sum.filtered);
+  extra("bytes_written", sum.written);
+  extra("bytes_read", sum.read);
+}
+
+inline void spill_statistics (const tuple_set &s) {
+  spill_statistics(vector<const tuple_set *>{&s});
+}
+
+inline void spill_statistics (const shared_set &s) {
+  vector<const tuple_set *> sets;
+  for (const tuple_set &t : s.shard)
+    sets.push_back(&t);
+  spill_statistics(sets);
+}
+
+// the filters held tuples in bytes; again if the search was run once
+// more with the exact memo
+inline void bloom_statistics (bigint tuples, bigint bytes, double rate,
+			      bool again) {
+  cout << "    bloom tuples    = ";
+  print_kmg(tuples);
+  cout << "    bloom bytes     = ";
+  print_kmg(bytes);
+  cout << "    bloom false pos = " << rate << endl;
+  cout << "    exact rerun     = " << (again ? "yes" : "no") << endl;
+  extra("bloom_tuples", tuples);
+  extra("bloom_bytes", bytes);
+  extra("bloom_false_positives", rate);
+  extra("exact_rerun", again);
+}
@@ -0,0 +1,12 @@
+#include "gyt-core-gmp.hpp"
+#include "gyt-mitm.hpp"
+
+const string header    = "Meet-in-the-Middle Separable Multiprecision Generalized Young Tableaux";
+const string underline = "======================================================================";
+
+//////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+  return run<mpz_class>(argc, argv);
+}
+//////////////////////////////////////////////////////////////////////////////
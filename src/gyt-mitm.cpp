@@ -0,0 +1,12 @@
+#include "gyt-core.hpp"
+#include "gyt-mitm.hpp"
+
+const string header    = "Meet-in-the-Middle Separable Generalized Young Tableaux";
+const string underline = "=======================================================";
+
+//////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+  return run<bigint>(argc, argv);
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,354 @@
+//////////////////////////////////////////////////////////////////////////////
+// If every monomial has at most one variable, p(x) = c + f_1(x_1) + ...
+// + f_k(x_k) with non-decreasing f_i.  The variables are split into two
+// halves of about the same number of tuples; the partial sums of each
+// half up to T = B - c are enumerated and sorted, and a two-pointer
+// join pairs the left sums s with the right sums T - s.
+//
+// If both halves do not fit into the memory limit, the range [0, T] of
+// the left sums is cut into bands, each holding few enough left sums s
+// and right sums T - s, as counted by a first pass.  Every band is
+// enumerated, sorted and joined on its own; the enumeration skips the
+// values of a variable whose sums end below the band, given the largest
+// sum of the variables after it.
+
+const bigint BUCKETS = 1 << 16;	// histogram of the first pass
+
+template <typename N>
+struct half {
+  vector<bigint> vars;
+  vector<bigint> shift;		// of each variable in the packed tuple
+  vector<val_tuple<N>> table;	// f_v(x) up to T, empty if not tabulated
+  val_tuple<N> rest;		// largest sum of the variables from i on
+};
+
+template <typename N>
+struct entry {
+  N sum;
+  bigint code;			// packed values of the variables
+  bool operator< (const entry &e) const {
+    return sum < e.sum || (sum == e.sum && code < e.code);
+  }
+};
+
+template <typename N>
+struct mitm {
+  const polynomial<N> &p;
+  const val_tuple<N> &bound;
+  N T;
+  vector<vector<pair<N, bigint>>> terms; // (coefficient, exponent)
+  half<N> left, right;
+  bool all;
+  bigint nres;
+  val_tuple<N> val;
+
+  mitm (const polynomial<N> &p, const val_tuple<N> &bound, bool all) :
+    p(p), bound(bound), T(0), terms(p.k), all(all), nres(0), val(p.k, 0) {}
+};
+
+// f_v(x), or T+1 if it exceeds T
+template <typename N>
+static N term (const mitm<N> &m, bigint v, const N &x) {
+  num_of_evals++;
+  N add = 0, mult;
+  for (const pair<N, bigint> &t : m.terms[v]) {
+    mult = t.first;
+    for (bigint e = 0; e < t.second; ++e) {
+      mult = mul_sat(mult, x);
+      if (mult > m.T)
+	return m.T + 1;
+    }
+    add = add_sat(add, mult);
+    if (add > m.T)
+      return m.T + 1;
+  }
+  return add;
+}
+
+template <typename N>
+static void init_half (mitm<N> &m, half<N> &h, bigint from, bigint to) {
+  bigint used = 0;
+  for (bigint v = from; v < to; ++v) {
+    bigint bits = bit_length(m.bound[v]);
+    if (used + bits > 64) {
+      cerr << "*** too many tuples in one half" << endl;
+      exit(1);
+    }
+    h.vars.push_back(v);
+    h.shift.push_back(used);
+    used += bits;
+    h.table.emplace_back();
+    if (m.bound[v] < max_table<N>())
+      for (bigint x = 0; x <= m.bound[v]; ++x) {
+	N t = term(m, v, N(x));
+	if (t > m.T)
+	  break;
+	h.table.back().push_back(t);
+      }
+  }
+  h.rest.assign(h.vars.size() + 1, N(0));
+  for (bigint i = h.vars.size(); i-- > 0; ) {
+    N top = add_sat(h.rest[i+1], term(m, h.vars[i], m.bound[h.vars[i]]));
+    h.rest[i] = min(top, N(m.T + 1));
+  }
+}
+
+// calls emit(sum, code) for the sums of h up to T; the sums are
+// non-decreasing in every variable, so enumeration stops as soon as
+// over(partial sum) holds, and skips the values as long as under(largest
+// sum from there) holds
+template <typename N, typename Over, typename Under, typename Emit>
+static void sums (const mitm<N> &m, const half<N> &h, bigint i,
+		  const N &sum, bigint code, const Over &over,
+		  const Under &under, Emit &emit) {
+  if (i == h.vars.size()) {
+    emit(sum, code);
+    return;
+  }
+  bigint v = h.vars[i];
+  const val_tuple<N> &tab = h.table[i];
+  const bool tabulated = m.bound[v] < max_table<N>();
+  N t, s;
+  // bisects for the first value not under(), the values below being
+  // those whose sums all end under it
+  bigint lo = 0, hi = tabulated ? tab.size() : word(m.bound[v], 0);
+  while (lo < hi) {
+    bigint x = lo + (hi - lo) / 2;
+    t = tabulated ? tab[x] : term(m, v, N(x));
+    if (t <= m.T - sum && under(add_sat(N(sum + t), h.rest[i+1])))
+      lo = x+1;
+    else
+      hi = x;
+  }
+  for (bigint x = lo; x <= m.bound[v]; ++x) {
+    if (!tabulated)
+      t = term(m, v, N(x));
+    else if (x < tab.size())
+      t = tab[x];
+    else
+      break;
+    if (t > m.T - sum)
+      break;
+    s = sum + t;
+    if (over(s))
+      break;
+    if (under(add_sat(s, h.rest[i+1])))
+      continue;
+    sums(m, h, i+1, s, code | x << h.shift[i], over, under, emit);
+  }
+}
+
+template <typename N>
+static bigint bucket (const mitm<N> &m, const N &s) {
+  return word(mul_div(s, N(BUCKETS), N(m.T + 1)), 0);
+}
+
+template <typename N>
+static void unpack (mitm<N> &m, const half<N> &h, bigint code) {
+  for (bigint i = 0; i < h.vars.size(); ++i) {
+    bigint bits = bit_length(m.bound[h.vars[i]]);
+    m.val[h.vars[i]] = code >> h.shift[i] & ((1UL << bits) - 1);
+  }
+}
+
+// pairs of sorted left and right sums adding up to T; false once the
+// first solution is found, if only one is wanted
+template <typename N>
+static bool join (mitm<N> &m, const vector<entry<N>> &L,
+		  const vector<entry<N>> &R) {
+  bigint i = 0, j = R.size();
+  N rest;
+  while (i < L.size() && j > 0) {
+    const N &sr = R[j-1].sum;
+    rest = m.T - sr;
+    if (L[i].sum < rest)
+      i++;
+    else if (L[i].sum > rest)
+      j--;
+    else {
+      bigint i2 = i, j2 = j;
+      while (i2 < L.size() && L[i2].sum == L[i].sum)
+	i2++;
+      while (j2 > 0 && R[j2-1].sum == sr)
+	j2--;
+      for (bigint a = i; a < i2; ++a)
+	for (bigint b = j2; b < j; ++b) {
+	  unpack(m, m.left, L[a].code);
+	  unpack(m, m.right, R[b].code);
+	  m.nres++;
+	  if (!m.all)
+	    return false;
+	  cout << endl << "*** solution for values:" << endl;
+	  for (bigint v = 0; v < m.p.k; ++v)
+	    cout << "    x_" << v+1 << " = " << m.val[v] << endl;
+	}
+      i = i2;
+      j = j2;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  bool all = false;
+  bigint limit = 1024;		// MB for the sums of both halves
+  double heartbeat = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "am:H:J:")) != -1)
+    if (opt == 'a')
+      all = true;
+    else if (opt == 'm')
+      limit = max(1LL, atoll(optarg));
+    else if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-a] [-m megabytes] [-H seconds]"
+	   << " [-J file]" << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  val_tuple<N> bound = get_bounds(p, B);
+
+  mitm<N> m(p, bound, all);
+  N c = 0;
+  for (bigint i = 0; i < p.coeffs.size(); ++i) {
+    bigint v = p.k, vars = 0;
+    for (bigint j = 0; j < p.k; ++j)
+      if (p.monomials[i][j] > 0) {
+	v = j;
+	vars++;
+      }
+    if (vars > 1) {
+      cerr << "*** polynomial not separable, use gyt or gyt-all" << endl;
+      exit(1);
+    }
+    if (v == p.k)
+      c += p.coeffs[i];
+    else
+      m.terms[v].push_back({p.coeffs[i], p.monomials[i][v]});
+  }
+
+  // split where the numbers of tuples of both halves are closest
+  bigint mid = 0;
+  long double tuples = 1, best = 0, lsize = 1;
+  for (bigint v = 0; v < p.k; ++v)
+    tuples *= as_real(bound[v]) + 1.0L;
+  long double prefix = 1;
+  for (bigint h = 0; h <= p.k; ++h) {
+    long double larger = max(prefix, tuples / prefix);
+    if (h == 0 || larger < best) {
+      best = larger;
+      lsize = prefix;
+      mid = h;
+    }
+    if (h < p.k)
+      prefix *= as_real(bound[h]) + 1.0L;
+  }
+
+  bigint nleft = 0, nright = 0, nbands = 0, maxband = 0;
+  phase("search");
+  start_progress(1, heartbeat);
+  if (c <= B) {
+    m.T = B - c;
+    init_half(m, m.left, 0, mid);
+    init_half(m, m.right, mid, p.k);
+    bigint cap = limit * 1024 * 1024 / sizeof(entry<N>);
+
+    // bands [b0, b1) of buckets of the left sums
+    vector<pair<bigint, bigint>> bands;
+    if (lsize + tuples / lsize < cap)
+      bands.push_back({0, BUCKETS});
+    else {
+      vector<bigint> count(BUCKETS, 0);
+      auto never = [](const N &) { return false; };
+      auto countl = [&](const N &s, bigint) { count[bucket(m, s)]++; };
+      auto countr = [&](const N &s, bigint) {
+	count[bucket(m, N(m.T - s))]++;
+      };
+      sums(m, m.left, 0, N(0), 0, never, never, countl);
+      sums(m, m.right, 0, N(0), 0, never, never, countr);
+      bigint b0 = 0, n = 0;
+      for (bigint b = 0; b < BUCKETS; ++b) {
+	if (n > 0 && n + count[b] > cap) {
+	  bands.push_back({b0, b});
+	  b0 = b;
+	  n = 0;
+	}
+	n += count[b];
+      }
+      bands.push_back({b0, BUCKETS});
+    }
+
+    vector<entry<N>> L, R;
+    for (const pair<bigint, bigint> &band : bands) {
+      bigint b0 = band.first, b1 = band.second;
+      L.clear();
+      R.clear();
+      auto overl = [&](const N &s) { return bucket(m, s) >= b1; };
+      auto overr = [&](const N &s) { return bucket(m, N(m.T - s)) < b0; };
+      auto underl = [&](const N &s) { return bucket(m, s) < b0; };
+      auto underr = [&](const N &s) {
+	return s <= m.T && bucket(m, N(m.T - s)) >= b1;
+      };
+      auto keepl = [&](const N &s, bigint code) {
+	if (bucket(m, s) >= b0)
+	  L.push_back({s, code});
+      };
+      auto keepr = [&](const N &s, bigint code) {
+	if (bucket(m, N(m.T - s)) < b1)
+	  R.push_back({s, code});
+      };
+      sums(m, m.left, 0, N(0), 0, overl, underl, keepl);
+      sums(m, m.right, 0, N(0), 0, overr, underr, keepr);
+      sort(L.begin(), L.end());
+      sort(R.begin(), R.end());
+      publish(0, m.val, L.size() + R.size(), 0);
+      nleft += L.size();
+      nright += R.size();
+      nbands++;
+      maxband = max(maxband, (bigint) (L.size() + R.size()));
+      if (!join(m, L, R))
+	break;
+    }
+  }
+
+  stop_progress();
+  phase("output");
+  stats.solutions = m.nres;
+  cout << endl;
+  if (all)
+    cout << "+++ number of solutions = " << m.nres << endl;
+  else if (m.nres > 0) {
+    cout << "+++ YES +++" << endl;
+    cout << "*** solution for values:" << endl;
+    for (bigint v = 0; v < p.k; ++v)
+      cout << "    x_" << v+1 << " = " << m.val[v] << endl;
+  } else
+    cout << "+++ NO solution +++" << endl;
+
+  cout << "*** split after x_" << mid << endl;
+  cout << "    # of left sums  = " << nleft << endl;
+  cout << "    # of right sums = " << nright << endl;
+  cout << "    # of bands      = " << nbands << endl;
+  cout << "    max band bytes  = " << maxband * sizeof(entry<N>) << endl;
+  cout << "    # of evals      = " << num_of_evals << endl;
+  extra("left_sums", nleft);
+  extra("right_sums", nright);
+  extra("bands", nbands);
+  extra("max_band_bytes", maxband * sizeof(entry<N>));
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
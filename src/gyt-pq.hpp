@@ -0,0 +1,144 @@
+#include <queue>
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+using val_res = pair<bigint, N>;	// arena slot, distance to B
+
+template <typename N>
+struct cmp_vr {
+  bool operator()(const val_res<N> &vr1, const val_res<N> &vr2)
+  {
+    return vr1.second >= vr2.second;
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  eval_state<N> es;
+  priority_queue<val_res<N>, vector<val_res<N>>, cmp_vr<N>> pq;
+  tuple_set memo;
+  tuple_arena<N> pool;
+  bigint maxstack = 1;
+  bool flip = true;
+  bigint nback = 0;
+  bigint split = 0;
+
+  residue_filter filter;
+  bool symmetric = true, residues = false;
+  double heartbeat = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "SrH:J:")) != -1)
+    if (opt == 'S')
+      symmetric = false;
+    else if (opt == 'r')
+      residues = true;
+    else if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-S] [-r] [-H seconds] [-J file]"
+	   << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  if (symmetric)
+    symmetries(p);
+  val_tuple<N> bound = get_bounds(p, B);
+  power_tables(p, bound);
+  if (residues)
+    init_filter(filter, p, B);
+  init_set(memo, bound);
+  if (!filter.moduli.empty())
+    init_columns(memo);
+  init_arena(pool, 2*p.k-1);
+
+  phase("search");
+  start_progress(1, heartbeat);
+  val_tuple<N> val(p.k, 0);
+  val[p.k-1] = bound[p.k-1];
+  val_tuple<N> valx(p.k), lim(p.k-1), node(2*p.k-1);
+  pack_node(p, val, bound, node.data());
+  pq.push(make_pair(alloc(pool, node.data()), N(0)));
+  insert(memo, val.data());
+  bool solution = false;
+  bigint dbl = 0;
+  while (!solution && !pq.empty() && !filter.impossible) {
+    bigint s = pq.top().first;
+    unpack_node(p, slot(pool, s), val, lim);
+    release(pool, s);
+    pq.pop();
+    publish(0, val, pq.size(), memo.count);
+    nback += !flip;
+    flip = false;
+
+    while (test_bound(val, bound, p.k) && val[p.k-1] >= 0 &&
+	   canonical_column(p, val)) {
+      N result = eval(p, es, val);
+      if (result > B && !skip_column(p, es, filter, B, val, result) &&
+	  !gallop(p, es, val, p.k-1, column_floor(p, val), B, result))
+	break;
+      if (result == B) {
+	solution = true;
+	break;
+      } else if (result < B) {
+	bigint put = 0;
+	for (bigint i = 0; i < p.k-1; ++i) {
+	  valx = val;
+	  valx[i]++;
+	  if (!canonical_step(p, val, i))
+	    continue;
+	  const N *kx = valx.data();
+	  if (contains(memo, kx)) {
+	    dbl++;
+	    continue;
+	  }
+	  if (column_done(p, es, B, memo, valx)) {
+	    dbl++;
+	    continue;
+	  }
+	  if (child_fits(p, es, B, valx, lim, i)) {
+	    N r = eval(p, es, valx);
+	    N d = r > B ? N(r - B) : N(B - r);
+	    pack_node(p, valx, lim, node.data());
+	    pq.push(make_pair(alloc(pool, node.data()), d));
+	    if (p.k > 2)
+	      insert(memo, kx);
+	    put++;
+	    flip = true;
+	  }
+	}
+	split += put > 1;
+	maxstack = max(maxstack, bigint(pq.size()));
+	break;
+      }
+    }
+  }
+
+  stop_progress();
+  phase("output");
+  stats.solutions = solution;
+  if (solution) {
+    cout << endl << "+++ YES +++" << endl;
+    cout << "*** solution for values:" << endl;
+    for (bigint i = 0; i < p.k; ++i)
+      cout << "    x_" << i+1 << " = " << val[i] << endl;
+  } else
+    cout << endl << "+++ NO solution +++" << endl;
+
+  statistics(memo.count, set_bytes(memo), "queue", maxstack,
+	     maxstack * ((2*p.k-1) * sizeof(N) + sizeof(val_res<N>)),
+	     split, nback, dbl);
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,74 @@
+#include <random>
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  eval_state<N> es;
+  double heartbeat = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "H:J:")) != -1)
+    if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-H seconds] [-J file]" << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  val_tuple<N> bound = get_bounds(p, B);
+  power_tables(p, bound);
+
+  random_device rd;
+  static uniform_int_distribution<int> uni_dist(0,p.k-2);
+  static default_random_engine dre(rd());
+
+  phase("search");
+  start_progress(1, heartbeat);
+  val_tuple<N> val(p.k, 0);
+  val[p.k-1] = bound[p.k-1];
+  bool solution = false;
+  bigint choice = 0;
+
+  while (test_bound(val, bound, p.k) &&
+	 val[p.k-1] >= 0) {
+    N result = eval(p, es, val);
+    if (result > B && !gallop(p, es, val, p.k-1, N(0), B, result))
+      break;
+    if (result == B) {
+      solution = true;
+      break;
+    } else if (result < B) {
+      val[uni_dist(dre)]++;
+      if (++choice % 1024 == 0)
+	publish(0, val, 0, 0);
+    }
+  }
+
+  stop_progress();
+  phase("output");
+  stats.solutions = solution;
+  if (solution) {
+    cout << endl << "+++ YES +++" << endl;
+    cout << "*** solution for values:" << endl;
+    for (bigint i = 0; i < p.k; ++i)
+      cout << "    x_" << i+1 << " = " << val[i] << endl;
+  } else
+    cout << endl << "+++ NO solution +++" << endl;
+  cout << "*** # of choices = " << choice << endl;
+  cout << "    # of evals   = " << num_of_evals << endl;
+  cout << "    # of deltas  = " << num_of_deltas << endl;
+  cout << "    steps saved  = " << num_of_saved << endl;
+  extra("choices", choice);
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,194 @@
+#include <random>
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  eval_state<N> es;
+  tuple_arena<N> stck;
+  tuple_set memo;
+  bigint maxstack = 1;
+  bool flip = true;
+  bigint nback = 0;
+  bigint split = 0;
+
+  residue_filter filter;
+  bool symmetric = true, residues = false;
+  bigint budget = 0;		// MB of memo, 0 for no bound
+  string spill;			// directory to spill the memo to
+  bigint quota = 0;		// MB on disk, 0 for no bound
+  double bloom = 0;		// bits per tuple of an approximate memo
+  double heartbeat = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "SrM:D:Q:a:e:H:J:")) != -1)
+    if (opt == 'S')
+      symmetric = false;
+    else if (opt == 'r')
+      residues = true;
+    else if (opt == 'M')
+      budget = max(1LL, atoll(optarg));
+    else if (opt == 'D')
+      spill = optarg;
+    else if (opt == 'Q')
+      quota = max(0LL, atoll(optarg));
+    else if (opt == 'a')
+      bloom = max(1.0, atof(optarg));
+    else if (opt == 'e')
+      bloom = bloom_bits(min(0.5, max(1e-9, atof(optarg))));
+    else if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-S] [-r]"
+	   << " [-M megabytes [-D dir [-Q megabytes]]] [-a bits | -e rate]"
+	   << " [-H seconds] [-J file]" << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+  if ((!spill.empty() && budget == 0) || (bloom > 0 && budget > 0)) {
+    cerr << "*** -D needs -M, and -a and -e exclude it" << endl;
+    exit(1);
+  }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  if (symmetric)
+    symmetries(p);
+  val_tuple<N> bound = get_bounds(p, B);
+  power_tables(p, bound);
+  if (residues)
+    init_filter(filter, p, B);
+  init_set(memo, bound);
+  if (!filter.moduli.empty())
+    init_columns(memo);
+  init_arena(stck, 2*p.k-1);
+
+  random_device rd;
+  static uniform_int_distribution<int> uni_dist(0,p.k-2);
+  static default_random_engine dre(rd());
+
+  phase("search");
+  start_progress(1, heartbeat);
+  val_tuple<N> val(p.k, 0);
+  val[p.k-1] = bound[p.k-1];
+  val_tuple<N> valx(p.k), lim(p.k-1), node(2*p.k-1);
+  vector<bigint> newstck(p.k);
+  if (budget > 0)
+    init_budget(memo, budget << 20, p, [&](vector<bigint> &mins) {
+      for (bigint i = 0; i < stck.count; ++i)
+	add_min(mins, &stck.data[i * stck.stride], p.k);
+      return add_sat(level(val.data(), p.k), 1UL);
+    });
+  if (!spill.empty())
+    init_spill(memo, spill, quota << 20);
+  init_approx(memo, bloom);
+  pack_node(p, val, bound, node.data());
+  push(stck, node.data());
+  insert(memo, val.data());
+  bool solution = false, again = false;
+  bigint dbl = 0, btuples = 0, bbytes = 0;
+  double rate = 0;
+  while (!solution && !filter.impossible) {
+    if (stck.count == 0) {
+      if (memo.approx == 0)
+	break;
+      // no solution past the filters: once more with the exact memo
+      btuples = memo.count;
+      bbytes = set_bytes(memo);
+      rate = bloom_rate(memo);
+      again = true;
+      init_approx(memo, 0);
+      init_set(memo, bound);
+      if (!filter.moduli.empty())
+	init_columns(memo);
+      fill(val.begin(), val.end(), 0);
+      val[p.k-1] = bound[p.k-1];
+      pack_node(p, val, bound, node.data());
+      push(stck, node.data());
+      insert(memo, val.data());
+    }
+    unpack_node(p, top(stck), val, lim);
+    pop(stck);
+    publish(0, val, stck.count, memo.count);
+    nback += !flip;
+    flip = false;
+
+    while (test_bound(val, bound, p.k) &&
+	   val[p.k-1] >= 0 && canonical_column(p, val)) {
+      N result = eval(p, es, val);
+      if (result > B && !skip_column(p, es, filter, B, val, result) &&
+	  !gallop(p, es, val, p.k-1, column_floor(p, val), B, result))
+	break;
+      if (result == B) {
+	solution = true;
+	break;
+      } else if (result < B) {
+	bigint put = 0;
+	for (bigint i = 0; i < p.k-1; ++i) {
+	  valx = val;
+	  valx[i]++;
+	  if (!canonical_step(p, val, i))
+	    continue;
+	  const N *kx = valx.data();
+	  if (contains(memo, kx)) {
+	    dbl++;
+	    continue;
+	  }
+	  if (column_done(p, es, B, memo, valx)) {
+	    dbl++;
+	    continue;
+	  }
+	  if (child_fits(p, es, B, valx, lim, i)) {
+	    newstck[put] = i;
+	    if (p.k > 2)
+	      insert(memo, kx);
+	    put++;
+	    flip = true;
+	  }
+	}
+	split += put > 1;
+	shuffle(newstck.begin(), newstck.begin() + put, dre);
+	for (bigint j = 0; j < put; ++j) {
+	  valx = val;
+	  valx[newstck[j]]++;
+	  pack_node(p, valx, lim, node.data());
+	  push(stck, node.data());
+	}
+	maxstack = max(maxstack, stck.count);
+	break;
+      }
+    }
+  }
+
+  stop_progress();
+  if (bloom > 0 && !again) {
+    btuples = memo.count;
+    bbytes = set_bytes(memo);
+    rate = bloom_rate(memo);
+  }
+  phase("output");
+  stats.solutions = solution;
+  if (solution) {
+    cout << endl << "+++ YES +++" << endl;
+    cout << "*** solution for values:" << endl;
+    for (bigint i = 0; i < p.k; ++i)
+      cout << "    x_" << i+1 << " = " << val[i] << endl;
+  } else
+    cout << endl << "+++ NO solution +++" << endl;
+
+  statistics(memo.count, set_bytes(memo), "stack",
+	     maxstack, maxstack * (2*p.k-1) * sizeof(N), split, nback, dbl);
+  if (budget > 0)
+    budget_statistics(memo);
+  if (!spill.empty())
+    spill_statistics(memo);
+  if (bloom > 0)
+    bloom_statistics(btuples, bbytes, rate, again);
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,375 @@
+#include <thread>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////////
+// The tableau is first expanded by one thread until its frontier below
+// the starting point val[k-1] = bound[k-1] has a tuple for every thread.
+// These tuples are dealt round robin to the deques of the threads, which
+// steal from each other when they run dry.  The first thread to reach B
+// raises a flag on which all the others stop.  With one thread the order
+// of the search is exactly the sequential one.  Only canonical tuples are
+// searched, see symmetries().  With unique set, every tuple is pushed by
+// one parent only, see unique_step(), and the memo is not kept.  With
+// -l, the tableau is walked level by level instead, see search_levels();
+// the solution is then one of the lowest level that has any.
+//
+// With prune set, a tuple is dropped if its box cannot reach B, see
+// prune_node().  Columns ruled out by the residue filter are not walked,
+// see skip_column().
+
+template <typename N>
+struct first_search {
+  const polynomial<N> &p;
+  const N B;
+  const val_tuple<N> &bound;
+  vector<work_deque<N>> deques;
+  shared_set memo;
+  mutex out;
+  atomic<bool> found;
+  atomic<bigint> pending;	// tuples queued or being expanded
+  vector<atomic<bigint>> hands;	// level of the node of each thread
+  val_tuple<N> solution;
+  bigint finder;
+  bool prune;			// drop nodes whose box cannot reach B
+  bool unique;			// one parent per tuple, see unique_step()
+  residue_filter filter;	// skip columns without solutions, if any
+  first_search (const polynomial<N> &p, const N &B, const val_tuple<N> &bound,
+		bigint jobs) :
+    p(p), B(B), bound(bound), deques(jobs), memo(jobs > 1 ? 64*jobs : 1),
+    hands(jobs) {
+    for (atomic<bigint> &h : hands)
+      h = 0;
+  }
+};
+
+struct worker_stats {
+  bigint maxstack = 1;
+  bigint nback = 0;
+  bigint split = 0;
+  bigint dbl = 0;
+  bigint steals = 0;
+  bigint evals = 0;
+  bigint deltas = 0;
+  long long saved = 0;
+  bigint cuts = 0;
+  bigint boxes = 0;
+  bigint pruned = 0;
+  long double volume = 0;
+  bigint columns = 0;
+  bigint filtered = 0;
+};
+
+// with seed set, works alone until its deque holds a tuple per thread
+template <typename N>
+static void worker (first_search<N> &s, bigint id, worker_stats &ws,
+		    bool seed) {
+  const polynomial<N> &p = s.p;
+  const bigint jobs = s.deques.size();
+  const bigint evals0 = num_of_evals, deltas0 = num_of_deltas;
+  const long long saved0 = num_of_saved;
+  const bigint cuts0 = num_of_cuts;
+  const bigint boxes0 = num_of_boxes, pruned0 = num_of_pruned;
+  const long double volume0 = pruned_volume;
+  const bigint columns0 = num_of_columns, filtered0 = num_of_filtered;
+  eval_state<N> es;
+  val_tuple<N> val(p.k), valx(p.k), lim(p.k-1), node(2*p.k-1);
+  val_tuple<N> lo(p.k), hi(p.k);
+  bool flip = true;
+  bigint frontier = 0, added = 0;
+  const bool bounded = s.memo.shard[0].limit != 0;
+  const bool memo = p.k > 2 && !s.unique;
+  while (!s.found) {
+    if (seed && deque_size(s.deques[id]) >= jobs)
+      break;
+    if (bounded)
+      s.hands[id].store(0, memory_order_relaxed);
+    if (!pop(s.deques[id], node.data())) {
+      bool stolen = false;
+      for (bigint v = 1; v < jobs && !stolen && !seed; ++v)
+	stolen = steal(s.deques[(id+v) % jobs], node.data());
+      if (!stolen) {
+	if (s.pending == 0 || seed)
+	  break;
+	this_thread::yield();
+	continue;
+      }
+      ws.steals++;
+    }
+    unpack_node(p, node.data(), val, lim);
+    if (bounded)
+      s.hands[id].store(level(val.data(), p.k), memory_order_relaxed);
+    publish(id, val, frontier, added);
+    ws.nback += !flip;
+    flip = false;
+    if (s.prune && prune_node(p, s.B, val, lim, lo, hi)) {
+      s.pending--;
+      continue;
+    }
+
+    bigint put = 0;
+    while (test_bound(val, s.bound, p.k) && val[p.k-1] >= 0 &&
+	   canonical_column(p, val) && !s.found) {
+      N result = eval(p, es, val);
+      if (result > s.B &&
+	  !skip_column(p, es, s.filter, s.B, val, result) &&
+	  !gallop(p, es, val, p.k-1, column_floor(p, val), s.B, result))
+	break;
+      if (result == s.B) {
+	lock_guard<mutex> guard(s.out);
+	if (!s.found) {
+	  s.found = true;
+	  s.solution = val;
+	  s.finder = id;
+	}
+	break;
+      } else if (result < s.B) {
+	for (bigint i = 0; i < p.k-1; ++i) {
+	  valx = val;
+	  valx[i]++;
+	  if (!canonical_step(p, val, i) || (s.unique && !unique_step(val, i)))
+	    continue;
+	  const N *kx = valx.data();
+	  if (memo && contains(s.memo, kx)) {
+	    ws.dbl++;
+	    continue;
+	  }
+	  if (!child_fits(p, es, s.B, valx, lim, i))
+	    continue;
+	  if (!memo || (!column_done(p, es, s.B, s.memo, valx) &&
+			insert(s.memo, kx))) {
+	    pack_node(p, valx, lim, node.data());
+	    push(s.deques[id], node.data());
+	    put++;
+	    added += memo;
+	    flip = true;
+	  } else
+	    ws.dbl++;
+	}
+	ws.split += put > 1;
+	frontier = deque_size(s.deques[id]);
+	ws.maxstack = max(ws.maxstack, frontier);
+	break;
+      }
+    }
+    s.pending += put;
+    s.pending--;
+  }
+  ws.evals += num_of_evals - evals0;
+  ws.deltas += num_of_deltas - deltas0;
+  ws.saved += num_of_saved - saved0;
+  ws.cuts += num_of_cuts - cuts0;
+  ws.boxes += num_of_boxes - boxes0;
+  ws.pruned += num_of_pruned - pruned0;
+  ws.volume += pruned_volume - volume0;
+  ws.columns += num_of_columns - columns0;
+  ws.filtered += num_of_filtered - filtered0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename N>
+int run (int argc, char **argv) {
+  N B;
+  polynomial<N> p;
+  bigint jobs = 1;
+  bool symmetric = true, prune = false, residues = false, unique = false;
+  bool levels = false;
+  bigint budget = 0;		// MB of memo, 0 for no bound
+  string spill;			// directory to spill the memo to
+  bigint quota = 0;		// MB on disk, 0 for no bound
+  double bloom = 0;		// bits per tuple of an approximate memo
+  double heartbeat = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "j:SprulM:D:Q:a:e:H:J:")) != -1)
+    if (opt == 'j')
+      jobs = max(1LL, atoll(optarg));
+    else if (opt == 'S')
+      symmetric = false;
+    else if (opt == 'p')
+      prune = true;
+    else if (opt == 'r')
+      residues = true;
+    else if (opt == 'u')
+      unique = true;
+    else if (opt == 'l')
+      levels = true;
+    else if (opt == 'M')
+      budget = max(1LL, atoll(optarg));
+    else if (opt == 'D')
+      spill = optarg;
+    else if (opt == 'Q')
+      quota = max(0LL, atoll(optarg));
+    else if (opt == 'a')
+      bloom = max(1.0, atof(optarg));
+    else if (opt == 'e')
+      bloom = bloom_bits(min(0.5, max(1e-9, atof(optarg))));
+    else if (opt == 'H')
+      heartbeat = atof(optarg);
+    else if (opt == 'J')
+      json_stats(optarg, argv[0]);
+    else {
+      cerr << "usage: " << argv[0] << " [-j threads] [-S] [-p] [-r] [-u]"
+	   << " [-l] [-M megabytes [-D dir [-Q megabytes]]]"
+	   << " [-a bits | -e rate] [-H seconds] [-J file]" << endl;
+      usage_hand_off<N>(argv[0]);
+      exit(1);
+    }
+  if ((!spill.empty() && budget == 0) ||
+      (bloom > 0 && (budget > 0 || unique || levels))) {
+    cerr << "*** -D needs -M, and -a and -e exclude -M, -u and -l" << endl;
+    exit(1);
+  }
+  if ((unique && levels) || (budget > 0 && (unique || levels))) {
+    cerr << "*** -u and -l exclude each other and -M" << endl;
+    exit(1);
+  }
+
+  phase("read_input");
+  read_input(p, B);
+  phase("get_bounds");
+  if (symmetric)
+    symmetries(p);
+  val_tuple<N> bound = get_bounds(p, B);
+  power_tables(p, bound);
+
+  first_search<N> s(p, B, bound, jobs);
+  init_shared(s.memo, bound, jobs > 1);
+  for (work_deque<N> &d : s.deques)
+    init_deque(d, 2*p.k-1, jobs > 1);
+  s.found = false;
+  s.prune = prune;
+  s.unique = unique;
+  if (residues)
+    init_filter(s.filter, p, B);
+  if (!s.filter.moduli.empty())
+    init_columns(s.memo);
+  if (budget > 0)
+    init_budget(s.memo, budget << 20, p, [&s, &p](vector<bigint> &mins) {
+      return frontier_floor(s.deques, s.hands, p.k, mins);
+    });
+  if (!spill.empty())
+    init_spill(s.memo, spill, quota << 20);
+  init_approx(s.memo, bloom);
+
+  phase("search");
+  start_progress(jobs, heartbeat);
+  val_tuple<N> val(p.k, 0), node(2*p.k-1);
+  val[p.k-1] = bound[p.k-1];
+  pack_node(p, val, bound, node.data());
+  level_search<N> l(p, B, bound, s.filter, prune,
+		    [&s](const val_tuple<N> &v) {
+		      s.found = true;
+		      s.solution = v;
+		      s.finder = 0;
+		      return false;
+		    });
+  vector<worker_stats> ws(jobs);
+  worker_stats seed;
+  seed.maxstack = 0;
+  bigint btuples = 0, bbytes = 0;
+  double rate = 0;
+  bool again = false;		// searched again with the exact memo
+  for (;;) {
+    s.pending = 0;
+    if (levels) {
+      if (!s.filter.impossible)
+	l.level = node;
+    } else if (!s.filter.impossible) {
+      push(s.deques[0], node.data());
+      if (!unique)
+	insert(s.memo, val.data());
+      s.pending = 1;
+    }
+
+    if (levels)
+      search_levels(l, jobs);
+    else if (jobs > 1) {
+      worker(s, 0, seed, true);
+      const bigint stride = node.size();
+      val_tuple<N> buf;
+      while (pop(s.deques[0], node.data()))
+	buf.insert(buf.end(), node.begin(), node.end());
+      for (bigint i = 0; i * stride < buf.size(); ++i)
+	push(s.deques[i % jobs], &buf[i * stride]);
+    }
+    vector<thread> threads;
+    for (bigint t = 0; t < jobs && !levels; ++t)
+      threads.emplace_back(worker<N>, ref(s), t, ref(ws[t]), false);
+    for (thread &t : threads)
+      t.join();
+    if (bloom == 0 || again)
+      break;
+    btuples = set_count(s.memo);
+    bbytes = set_bytes(s.memo);
+    rate = bloom_rate(s.memo);
+    if (s.found)
+      break;
+    again = true;
+    init_approx(s.memo, 0);
+    init_shared(s.memo, bound, jobs > 1);
+    if (!s.filter.moduli.empty())
+      init_columns(s.memo);
+  }
+  stop_progress();
+
+  bigint maxstack = seed.maxstack, nback = seed.nback, split = seed.split;
+  bigint dbl = seed.dbl;
+  num_of_evals += seed.evals;
+  num_of_deltas += seed.deltas;
+  num_of_saved += seed.saved;
+  num_of_cuts += seed.cuts;
+  num_of_boxes += seed.boxes;
+  num_of_pruned += seed.pruned;
+  pruned_volume += seed.volume;
+  num_of_columns += seed.columns;
+  num_of_filtered += seed.filtered;
+  for (const worker_stats &w : ws) {
+    maxstack += w.maxstack;
+    nback += w.nback;
+    split += w.split;
+    dbl += w.dbl;
+    num_of_evals += w.evals;
+    num_of_deltas += w.deltas;
+    num_of_saved += w.saved;
+    num_of_cuts += w.cuts;
+    num_of_boxes += w.boxes;
+    num_of_pruned += w.pruned;
+    pruned_volume += w.volume;
+    num_of_columns += w.columns;
+    num_of_filtered += w.filtered;
+  }
+
+  phase("output");
+  stats.solutions = s.found;
+  if (s.found) {
+    cout << endl << "+++ YES +++" << endl;
+    cout << "*** solution for values:" << endl;
+    for (unsigned int i = 0; i < p.k; ++i)
+      cout << "    x_" << i+1 << " = " << s.solution[i] << endl;
+  } else
+    cout << endl << "+++ NO solution +++" << endl;
+
+  if (levels)
+    level_statistics(l);
+  else
+    statistics(set_count(s.memo), set_bytes(s.memo), "stack",
+	       maxstack, maxstack * (2*p.k-1) * sizeof(N), split, nback, dbl);
+  if (budget > 0)
+    budget_statistics(s.memo);
+  if (!spill.empty())
+    spill_statistics(s.memo);
+  if (bloom > 0)
+    bloom_statistics(btuples, bbytes, rate, again);
+  if (jobs > 1 && !levels) {
+    if (s.found)
+      cout << "    found by worker = " << s.finder << endl;
+    cout << "    seed evals      = " << seed.evals + seed.deltas << endl;
+    for (bigint t = 0; t < jobs; ++t)
+      cout << "    worker " << t << " evals  = " << ws[t].evals + ws[t].deltas
+	   << " (" << ws[t].steals << " steals)" << endl;
+  }
+  write_stats();
+  return 0;
+}
+//////////////////////////////////////////////////////////////////////////////